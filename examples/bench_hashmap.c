@@ -0,0 +1,173 @@
+//benchmark of the vertex hashmap on adversarial index patterns, build and run from the repository root with:
+//	cc -std=c99 -O2 -pthread examples/bench_hashmap.c -o bench_hashmap && ./bench_hashmap
+//every pattern inserts its keys and then looks all of them up again, printing the probe statistics of the map
+//the linear hash the map used to have is shown for comparison, as the most keys it put in the same home group
+//returns 0 if the probe lengths of every pattern stayed within the bounds below, which grow with the logarithm of the map size
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define QOBJ_STATS
+#define QOBJ_IMPLEMENTATION
+#include "../quickobj.h"
+
+#define BENCH_MAX_MEAN_PROBES 1.5 //most groups an average lookup may search
+
+//returns the most groups any single lookup may search in a map with [cap] slots, the longest probe of a well mixed
+//hash grows with the logarithm of the number of groups, while a clustering hash probes a number of groups linear in the keys
+static uint32_t bench_max_probes(uint32_t cap)
+{
+	uint32_t log2Groups = 0;
+	while(((uint32_t)QOBJ_HASHMAP_GROUP_SIZE << log2Groups) < cap)
+		log2Groups++;
+
+	return 2 * (log2Groups > 4 ? log2Groups : 4);
+}
+
+//----------------------------------------------------------------------//
+//PATTERNS:
+
+//fills [keys] with the [count] keys of a pattern, all of them unique
+typedef void (*BenchPattern)(QOBJvertexRef* keys, uint32_t count);
+
+//positions, normals and tex coords walk the 3 axes of a cube of indices, like a regular grid mesh
+static void pattern_grid(QOBJvertexRef* keys, uint32_t count)
+{
+	uint32_t side = 1;
+	while(side * side * side < count)
+		side++;
+
+	for(uint32_t i = 0; i < count; i++)
+	{
+		keys[i].pos      = 1 + i % side;
+		keys[i].normal   = 1 + (i / side) % side;
+		keys[i].texCoord = 1 + i / (side * side);
+	}
+}
+
+//positions step by a power of 2 that is larger than any map, so every key has the same low bits
+static void pattern_strided(QOBJvertexRef* keys, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		keys[i].pos      = 1 + i * 4096;
+		keys[i].normal   = 1;
+		keys[i].texCoord = 1;
+	}
+}
+
+//positions and normals step by the power of 2 of the packed key width, so only high bits of the packed key change
+static void pattern_high_bits(QOBJvertexRef* keys, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		keys[i].pos      = 1 + (i & 0x3FF) * 2048;
+		keys[i].normal   = 1 + (i >> 10) * 2048;
+		keys[i].texCoord = 1;
+	}
+}
+
+//positions and normals trade off against each other so 12637 * pos + 16369 * normal never changes,
+//every key collides under the linear hash at any capacity (the indices wrap around for large counts, which keeps both true)
+static void pattern_colliding(QOBJvertexRef* keys, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		keys[i].pos      = 1 + 16369 * i;
+		keys[i].normal   = 1 + 12637 * (count - i);
+		keys[i].texCoord = 1;
+	}
+}
+
+//----------------------------------------------------------------------//
+//BENCHMARK:
+
+//the hash the map used before it mixed its keys
+static uint32_t linear_hash(QOBJvertexRef key)
+{
+	return 12637 * key.pos + 16369 * key.normal + 20749 * key.texCoord;
+}
+
+//returns the most keys the linear hash puts in the same group of a map with [cap] slots
+static uint32_t linear_max_group(const QOBJvertexRef* keys, uint32_t count, uint32_t cap)
+{
+	uint32_t numGroups = cap / QOBJ_HASHMAP_GROUP_SIZE;
+	uint32_t* groups = (uint32_t*)calloc(numGroups, sizeof(uint32_t));
+
+	uint32_t maxGroup = 0;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint32_t group = (linear_hash(keys[i]) & (cap - 1)) / QOBJ_HASHMAP_GROUP_SIZE;
+		if(++groups[group] > maxGroup)
+			maxGroup = groups[group];
+	}
+
+	free(groups);
+	return maxGroup;
+}
+
+//returns 1 if the probe lengths stayed within bounds
+static int bench_pattern(const char* name, BenchPattern pattern, uint32_t count)
+{
+	QOBJvertexRef* keys = (QOBJvertexRef*)malloc(count * sizeof(QOBJvertexRef));
+	pattern(keys, count);
+
+	QOBJdedupStats stats;
+	memset(&stats, 0, sizeof(QOBJdedupStats));
+
+	QOBJvertexHashmap map;
+	if(qobj_hashmap_create(&map, 32, 1, qobj_get_allocator(NULL)) != QOBJ_SUCCESS)
+	{
+		printf("%-10s out of memory\n", name);
+		free(keys);
+		return 0;
+	}
+	map.stats = &stats;
+
+	//insert every key, then look every key up again:
+	//---------------
+	clock_t start = clock();
+
+	int32_t valid = 1;
+	for(uint32_t pass = 0; pass < 2; pass++)
+	{
+		for(uint32_t i = 0; i < count; i++)
+		{
+			uint32_t val = i;
+			if(qobj_hashmap_get_or_add(&map, keys[i], &val) != QOBJ_SUCCESS || val != i)
+				valid = 0;
+		}
+	}
+
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	qobj_stats_finish(&stats);
+
+	int32_t bounded = stats.meanProbes <= BENCH_MAX_MEAN_PROBES && stats.maxProbes <= bench_max_probes(map.cap);
+	printf("%-10s %8u keys  %6.1f ns/lookup  mean probes %5.3f  max probes %3u (bound %2u)  resizes %2u  linear hash max group %7u  %s\n",
+	       name, count, seconds * 1e9 / (double)stats.lookups, stats.meanProbes, stats.maxProbes, bench_max_probes(map.cap), stats.resizes,
+	       linear_max_group(keys, count, map.cap), !valid ? "WRONG VALUES" : bounded ? "ok" : "UNBOUNDED");
+
+	qobj_hashmap_free(map);
+	free(keys);
+
+	return valid && bounded;
+}
+
+int main(void)
+{
+	uint32_t counts[] = {1000, 100000, 1000000};
+
+	int32_t passed = 1;
+	for(uint32_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+	{
+		passed &= bench_pattern("grid",      pattern_grid,      counts[i]);
+		passed &= bench_pattern("strided",   pattern_strided,   counts[i]);
+		passed &= bench_pattern("high bits", pattern_high_bits, counts[i]);
+		passed &= bench_pattern("colliding", pattern_colliding, counts[i]);
+	}
+
+	printf("%s\n", passed ? "all probe lengths bounded" : "some probe lengths unbounded");
+	return passed ? 0 : 1;
+}
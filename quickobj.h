@@ -13,6 +13,20 @@
  * if you wish to use a custom memory allocator instead of the default malloc(), you must 
  * "#define QOBJ_MALLOC(s) my_malloc(s)", "#define QOBJ_FREE(p) my_free(p)", and "#define QOBJ_REALLOC(p, s) my_realloc(p, s)"
  * before including the library in the same source file you used "#define QOBJ_IMPLEMENTATION"
+ * to use a different allocator per load instead (such as an arena freed all at once), pass a QOBJallocator in QOBJloadOptions
+ * 
+ * on POSIX systems, files loaded from a path are memory-mapped and parsed in place. if you wish to stream them
+ * in blocks through stdio instead, you must "#define QOBJ_NO_MMAP" in the same source file. the size of each
+ * block read from a file or a QOBJreader can be changed with "#define QOBJ_READ_BLOCK_SIZE n"
+ * 
+ * line scanning uses AVX2, SSE2 or NEON when the compiler targets them, "#define QOBJ_NO_SIMD" to use only scalar code
+ * 
+ * to collect statistics of vertex deduplication in QOBJdedupStats, you must "#define QOBJ_STATS" in the same source file you
+ * used "#define QOBJ_IMPLEMENTATION". without it, no statistics are collected and the counting code is not compiled at all
+ * 
+ * on POSIX systems, QOBJ_LOAD_PARALLEL and QOBJ_LOAD_PIPELINED use pthreads (link with -pthread). "#define QOBJ_NO_THREADS"
+ * to always parse and read on the calling thread. each thread parses at least QOBJ_MIN_CHUNK_SIZE bytes (1 MiB by default), and a custom allocator
+ * must be thread-safe when the flag is used
  * 
  * the following strutures, enums, and functions are defined for end use:
  * (all other functions/structures are meant for internal library use only and do not have documentation)
@@ -45,10 +59,65 @@
  * 			array of vertices (float*)
  * 			
  * 			number of indices (uint32_t); index buffer capacity (uint32_t) (for internal use, please ignore)
- * 			array of indices (uint32_t*)
+ * 			array of indices (uint32_t*) (NULL if loaded with QOBJ_LOAD_NO_INDICES)
+ * 			first index (uint32_t) (the offset of the indices in the shared index buffer, see QOBJ_LOAD_SHARED_VERTICES)
  * 
  * 			material name (char*)
  * 
+ * 			block (void*) (the single allocation holding the mesh array and all buffers, see QOBJ_LOAD_SINGLE_BLOCK, NULL otherwise)
+ * 
+ * QOBJloadOptions
+ * 		options for loading a .obj file, get the defaults from qobj_default_load_options() and then modify them
+ * 		contains:
+ * 			flags (uint32_t) (bitfield of QOBJloadFlags)
+ * 			number of threads (uint32_t) (the most threads QOBJ_LOAD_PARALLEL will use, 0 to use one per core)
+ * 			weld position, normal, and tex coord epsilons (float) (the largest per-component differences QOBJ_LOAD_WELD merges,
+ * 			1e-5, 1e-3, and 1e-5 by default. a position epsilon of 0 only merges exactly equal positions)
+ * 			position, normal, and tex coord caps (uint32_t) (how many of each attribute the attribute arrays start with room for)
+ * 			vertex, index, and map caps (uint32_t) (how many vertices and indices each mesh, and how many vertices each mesh's
+ * 			vertex hashmap, start with room for. all caps are 32 by default, set them from known sizes to avoid growing the buffers.
+ * 			they are only hints: a buffer still grows past its cap, and a preflight pass or QOBJ_LOAD_PARALLEL sizes buffers exactly instead)
+ * 			growth factor (float) (how much a full attribute array, vertex buffer, or index buffer is grown by, 2 by default.
+ * 			must be greater than 1 and at most 8, loads return QOBJ_ERROR_INVALID_ARGS otherwise. vertex hashmaps always double,
+ * 			as their capacity must be a power of 2)
+ * 			context (QOBJcontext*) (scratch memory to reuse, see qobj_context_create(), NULL by default)
+ * 			allocator (const QOBJallocator*) (allocates the loaded meshes or materials, and the scratch memory if there is no context,
+ * 			NULL by default to use QOBJ_MALLOC, QOBJ_REALLOC, and QOBJ_FREE)
+ * 			dedup stats (QOBJdedupStats*) (filled in by the load if not NULL and QOBJ_STATS is defined, NULL by default)
+ * 
+ * QOBJdedupStats
+ * 		statistics of the vertex hashmaps used by a load, to tell slow parsing apart from slow hashing
+ * 		vertices deduplicated with QOBJ_LOAD_SORT_DEDUP or not deduplicated at all are not looked up in a hashmap, so they are not counted
+ * 		contains:
+ * 			number of lookups (uint64_t) (one per face corner); number of hits (uint64_t) (lookups that found an existing vertex)
+ * 			total probes (uint64_t) (groups of QOBJ_HASHMAP_GROUP_SIZE slots searched by all lookups); max probes (uint32_t) (most by one lookup)
+ * 			mean probes (double) (total probes / number of lookups, 1.0 is ideal)
+ * 			number of resizes (uint32_t) (times a map grew or switched to wide keys)
+ * 			bytes (size_t) (memory held by all maps at the end of the load); peak bytes (size_t) (most memory held at once)
+ * 
+ * QOBJcontext
+ * 		an opaque store of the scratch memory a load needs (attribute arrays, vertex hashmaps, mesh builders), create one with
+ * 		qobj_context_create() and set it in QOBJloadOptions to keep that memory between loads instead of reallocating it every time
+ * 		a context may only be used by one load at a time. the meshes a load returns never point into it, so they outlive it
+ * 		all scratch memory of a load that uses a context is allocated with the context's allocator, not the load's
+ * 
+ * QOBJallocator
+ * 		a user-supplied memory allocator, every allocation of a load it is passed to is made through it
+ * 		contains:
+ * 			alloc callback (void* (*)(void* user, size_t size)) (returns NULL when out of memory)
+ * 			realloc callback (void* (*)(void* user, void* ptr, size_t oldSize, size_t newSize)) (ptr is NULL when oldSize is 0,
+ * 			the old size is given so an arena can copy the block without storing its size)
+ * 			free callback (void (*)(void* user, void* ptr)) (never called with NULL, may do nothing for an arena freed all at once)
+ * 			user data (void*) (passed to all callbacks)
+ * 		NOTE: with QOBJ_LOAD_PARALLEL or QOBJ_LOAD_PIPELINED, the callbacks may be called from multiple threads at once
+ * 
+ * QOBJreader
+ * 		a user-supplied source of bytes, used to load from archives, virtual file systems, etc. without a temporary file
+ * 		contains:
+ * 			read callback (size_t (*)(void* user, char* buf, size_t len)) (returns the number of bytes read, 0 at the end of the data, or SIZE_MAX on error)
+ * 			size callback (size_t (*)(void* user)) (optional, returns the total size of the data, used to avoid over-allocating for small inputs)
+ * 			user data (void*) (passed to both callbacks)
+ * 
  * ENUMS:
  * ------------------------------------------------------------------------
  * QOBJerror
@@ -57,6 +126,43 @@
  * QOBJvertexAttributes
  * 		all possible attributes that a vertex could have, a mesh's vertex attributes will be an OR of 1 or more of these
  * 
+ * QOBJloadFlags
+ * 		flags that change how a .obj file is loaded, OR any number of them into QOBJloadOptions.flags:
+ * 			QOBJ_LOAD_PREFLIGHT: makes a fast counting pass over the file first, so the attribute arrays, index buffers,
+ * 			and vertex hashmaps are allocated once at their final size instead of growing. only applies when the whole
+ * 			file is in memory (memory-mapped files and qobj_load_obj_from_memory), it is ignored for QOBJreaders
+ * 			QOBJ_LOAD_PARALLEL: splits the file into chunks of whole lines and parses them on multiple threads, then builds the
+ * 			meshes in file order, so the result is identical to a serial load. only applies when the whole file is in memory,
+ * 			and QOBJ_LOAD_PREFLIGHT has no effect with it (the attribute arrays are already counted and allocated once)
+ * 			QOBJ_LOAD_PIPELINED: reads each block of a QOBJreader on a background thread while the previous one is parsed,
+ * 			so slow storage and parsing overlap. qobj_load_obj_opts then streams the file through stdio instead of mapping it,
+ * 			which also disables QOBJ_LOAD_PREFLIGHT and QOBJ_LOAD_PARALLEL for it. blocks are read on the calling thread without pthreads
+ * 			QOBJ_LOAD_SORT_DEDUP: instead of looking up every face corner in a hashmap as it is read, stores the corners and
+ * 			deduplicates them with a radix sort once the file is read. the result is identical, but it is much faster for large
+ * 			meshes whose faces do not reuse vertices in order, at the cost of about 36 bytes of scratch memory per corner
+ * 			QOBJ_LOAD_NO_DEDUP: skips vertex deduplication entirely and writes every face corner as a new vertex, so the meshes
+ * 			are triangle soups with indices 0, 1, 2, ... this is the fastest way to load when the vertices are not shared anyway,
+ * 			or when the caller welds them itself. overrides QOBJ_LOAD_SORT_DEDUP
+ * 			QOBJ_LOAD_NO_INDICES: same as QOBJ_LOAD_NO_DEDUP, but no index buffer is created: every 3 vertices define a triangle,
+ * 			each mesh's indices are NULL and its number of indices is 0
+ * 			QOBJ_LOAD_WELD: after the vertices of a mesh are deduplicated, also merges vertices whose positions, normals, and tex coords
+ * 			are all within the weld epsilons of QOBJloadOptions, using a spatial hash grid. this catches exporters that write the same
+ * 			position under many different indices. the first vertex of each group is kept, and vertex order is otherwise preserved.
+ * 			merging is greedy, so vertices further apart than the epsilons are never merged. has no effect with QOBJ_LOAD_NO_INDICES
+ * 			QOBJ_LOAD_SHARED_VERTICES: deduplicates vertices across all materials into one vertex buffer, and puts all indices into one
+ * 			index buffer in which each mesh owns a contiguous range. every mesh points to the same vertices (with the same
+ * 			layout, the union of all faces' attributes, missing attributes are 0), and its indices point [first index] entries
+ * 			into the first mesh's indices, so the model can be drawn from 2 buffers with one draw per mesh. the buffers are
+ * 			owned by the first mesh. QOBJ_LOAD_NO_INDICES is treated as QOBJ_LOAD_NO_DEDUP with it, as ranges need an index buffer
+ * 			QOBJ_LOAD_SINGLE_BLOCK: once the meshes are built, moves the mesh array and every mesh's vertices, indices, and material name
+ * 			into a single allocation that starts at the mesh array: first the meshes, then all vertices, then all indices, then the
+ * 			names, with every vertex and index buffer starting a multiple of 16 bytes into it. the whole model can then be handed
+ * 			off as one block, which every mesh's [block] points to. it is freed with a single call to qobj_free_obj (or by freeing
+ * 			[block] with the allocator it was loaded with). costs one extra copy of the vertices and indices
+ * 			QOBJ_LOAD_SHRINK_TO_FIT: once the meshes are built, reallocates every vertex and index buffer that has room for more
+ * 			than it holds to exactly its size, so meshes kept for a long time do not hold on to the slack left by growing the
+ * 			buffers while loading. has no effect with QOBJ_LOAD_SINGLE_BLOCK, whose buffers are always exact
+ * 
  * FUNCTIONS:
  * ------------------------------------------------------------------------
  * QOBJerror qobj_load_obj(const char* path, uint32_t* numMeshes, QOBJmesh** meshes)
@@ -65,16 +171,67 @@
  * 		the [meshes] field is populated with all of the loaded meshes
  * 		NOTE: in order to render the entire model, you must render each mesh in the array, using its corresponding material (loaded separately)
  * 
+ * QOBJerror qobj_load_obj_opts(const char* path, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes)
+ * 		identical to qobj_load_obj, but loads with [options] (see struct definition), or the defaults if [options] is NULL
+ * 
+ * QOBJerror qobj_reload_obj(const char* path, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes)
+ * 		identical to qobj_load_obj_opts, but [numMeshes] and [meshes] must hold meshes returned by an earlier load with the same
+ * 		allocator (or be 0 and NULL). each new mesh takes the vertex and index buffers of the old mesh with the same material
+ * 		(or of any old mesh left) and only grows them if they are too small, so reloading an edited file barely allocates.
+ * 		the old meshes are always freed, even if the reload fails. the buffers of old meshes packed into a single block
+ * 		(see QOBJ_LOAD_SINGLE_BLOCK) are not reused, the block is freed instead. [options] need not have the flags of the old load
+ * 
+ * QOBJloadOptions qobj_default_load_options()
+ * 		returns the options qobj_load_obj uses, modify the result to pass to any function taking a QOBJloadOptions*
+ * 
+ * QOBJerror qobj_context_create(const QOBJallocator* allocator, QOBJcontext** context)
+ * 		creates an empty context in [context], its memory grows to fit the loads it is used with
+ * 		the context and all of its memory are allocated with [allocator], or QOBJ_MALLOC if it is NULL
+ * 
+ * void qobj_context_free(QOBJcontext* context)
+ * 		frees [context] and all of the memory it kept
+ * 
+ * QOBJerror qobj_load_obj_from_memory(const char* data, size_t len, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes)
+ * 		loads a .obj file whose contents are already in memory, [data] must point to [len] bytes
+ * 		[data] is owned by the caller, it is only read during the call and does not need to be null-terminated
+ * 		the [options], [numMeshes] and [meshes] fields are used exactly as in qobj_load_obj_opts
+ * 
+ * QOBJerror qobj_load_obj_ex(const QOBJreader* reader, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes)
+ * 		loads a .obj file whose contents are pulled in large blocks through [reader] (see struct definition)
+ * 		with QOBJ_LOAD_PIPELINED, [reader]'s callbacks are called from a background thread
+ * 		the [options], [numMeshes] and [meshes] fields are used exactly as in qobj_load_obj_opts
+ * 
  * void qobj_free_obj(uint32_t numMeshes, QOBJmesh* meshes)
  * 		frees the memory created by a call to qobj_load_obj, must be called in order to prevent memory leaks
+ * 		NOTE: with QOBJ_LOAD_SHARED_VERTICES, the shared buffers are only freed with the whole array, never free a single mesh
+ * 		NOTE: meshes loaded with QOBJ_LOAD_SINGLE_BLOCK are freed as one block, found through their [block]
+ * 
+ * void qobj_free_obj_opts(uint32_t numMeshes, QOBJmesh* meshes, const QOBJloadOptions* options)
+ * 		identical to qobj_free_obj, but frees with the allocator of the [options] the meshes were loaded with
  * 
  * QOBJerror qobj_load_mtl(const char* path, uint32_t* numMaterials, QOBJmaterial** materials)
  * 		loads a .mtl file from [path]
  * 		the [numMaterials] field is populated with the number of materials loaded
  * 		the [materials] field is populated with all of the loaded materials
  * 
+ * QOBJerror qobj_load_mtl_opts(const char* path, const QOBJloadOptions* options, uint32_t* numMaterials, QOBJmaterial** materials)
+ * 		identical to qobj_load_mtl, but allocates with the allocator of [options], or the default one if [options] is NULL
+ * 		the other fields of [options] do not apply to .mtl files and are ignored
+ * 
+ * QOBJerror qobj_load_mtl_from_memory(const char* data, size_t len, const QOBJloadOptions* options, uint32_t* numMaterials, QOBJmaterial** materials)
+ * 		loads a .mtl file whose contents are already in memory, [data] must point to [len] bytes
+ * 		[data] is owned by the caller, it is only read during the call and does not need to be null-terminated
+ * 		the [options], [numMaterials] and [materials] fields are used exactly as in qobj_load_mtl_opts
+ * 
+ * QOBJerror qobj_load_mtl_ex(const QOBJreader* reader, const QOBJloadOptions* options, uint32_t* numMaterials, QOBJmaterial** materials)
+ * 		loads a .mtl file whose contents are pulled in large blocks through [reader] (see struct definition)
+ * 		the [options], [numMaterials] and [materials] fields are used exactly as in qobj_load_mtl_opts
+ * 
  * void qobj_free_mtl(uint32_t numMaterials, QOBJmaterial* materials)
  * 		frees the memory created by a call to qobj_load_mtl, must be called in order to prevent memory leaks
+ * 
+ * void qobj_free_mtl_opts(uint32_t numMaterials, QOBJmaterial* materials, const QOBJloadOptions* options)
+ * 		identical to qobj_free_mtl, but frees with the allocator of the [options] the materials were loaded with
  */
 
 #ifndef QOBJ_H
@@ -86,6 +243,7 @@ extern "C"
 #endif
 
 #include <stdint.h>
+#include <stddef.h>
 
 //----------------------------------------------------------------------//
 //DECLARATIONS:
@@ -130,8 +288,11 @@ typedef struct QOBJmesh
 	uint32_t numIndices; //mesh only contains triangles, so the number of tris is numIndices / 3
 	uint32_t indexCap;
 	uint32_t* indices;
+	uint32_t firstIndex; //where indices starts in the index buffer shared with QOBJ_LOAD_SHARED_VERTICES, 0 otherwise
 
 	char* material;
+
+	void* block; //the allocation holding the whole model if loaded with QOBJ_LOAD_SINGLE_BLOCK, NULL otherwise
 } QOBJmesh;
 
 //an error value, returned by all functions which can have errors
@@ -141,7 +302,8 @@ typedef enum QOBJerror
 	QOBJ_ERROR_INVALID_FILE,
 	QOBJ_ERROR_IO,
 	QOBJ_ERROR_OUT_OF_MEM,
-	QOBJ_ERROR_UNSUPPORTED_DATA_TYPE
+	QOBJ_ERROR_UNSUPPORTED_DATA_TYPE,
+	QOBJ_ERROR_INVALID_ARGS
 } QOBJerror;
 
 //different attributes that the vertices within a mesh can have
@@ -152,31 +314,182 @@ typedef enum QOBJvertexAttributes
 	QOBJ_VERTEX_ATTRIB_TEX_COORDS = (1 << 2)
 } QOBJvertexAttributes;
 
+//a source of bytes supplied by the user, used in place of a file
+typedef struct QOBJreader
+{
+	size_t (*read)(void* user, char* buf, size_t len); //reads up to len bytes into buf, returns the number read, 0 at the end of the data, or SIZE_MAX on error
+	size_t (*size)(void* user);                        //returns the total number of bytes that will be read (optional, may be NULL)
+	void* user;
+} QOBJreader;
+
+//a memory allocator supplied by the user, used in place of QOBJ_MALLOC, QOBJ_REALLOC and QOBJ_FREE
+typedef struct QOBJallocator
+{
+	void* (*allocFn)(void* user, size_t size);                                  //returns NULL if out of memory
+	void* (*reallocFn)(void* user, void* ptr, size_t oldSize, size_t newSize); //ptr is NULL if oldSize is 0, returns NULL if out of memory
+	void (*freeFn)(void* user, void* ptr);                                      //ptr is never NULL
+	void* user;
+} QOBJallocator;
+
+//flags that change how a .obj file is loaded
+typedef enum QOBJloadFlags
+{
+	QOBJ_LOAD_PREFLIGHT       = (1 << 0), //count attributes and faces in a fast first pass, then allocate every buffer once
+	QOBJ_LOAD_PARALLEL        = (1 << 1), //split the file into chunks of lines and parse them on multiple threads
+	QOBJ_LOAD_PIPELINED       = (1 << 2), //read the next block on a background thread while the current one is parsed
+	QOBJ_LOAD_SORT_DEDUP      = (1 << 3), //deduplicate vertices by radix sorting every face corner once all faces are read
+	QOBJ_LOAD_NO_DEDUP        = (1 << 4), //write every face corner as its own vertex, indices are 0, 1, 2, ...
+	QOBJ_LOAD_NO_INDICES      = (1 << 5), //same as QOBJ_LOAD_NO_DEDUP, but no index buffer is created at all
+	QOBJ_LOAD_WELD            = (1 << 6), //merge vertices whose attributes are within the weld epsilons of each other
+	QOBJ_LOAD_SHARED_VERTICES = (1 << 7), //all meshes share one vertex buffer and one index buffer, each owning a range of indices
+	QOBJ_LOAD_SINGLE_BLOCK    = (1 << 8), //the mesh array and all of its buffers and names are packed into one allocation
+	QOBJ_LOAD_SHRINK_TO_FIT   = (1 << 9)  //every vertex and index buffer is trimmed to exactly its size once the meshes are built
+} QOBJloadFlags;
+
+//scratch memory kept between loads, see qobj_context_create()
+typedef struct QOBJcontext QOBJcontext;
+
+//statistics of the vertex hashmaps used by a load, only collected if QOBJ_STATS is defined
+typedef struct QOBJdedupStats
+{
+	uint64_t lookups;     //vertices looked up, one per face corner
+	uint64_t hits;        //lookups that found an existing vertex
+	uint64_t totalProbes; //groups of slots searched by all lookups
+	uint32_t maxProbes;   //most groups searched by a single lookup
+	double meanProbes;    //totalProbes / lookups
+
+	uint32_t resizes; //times a map grew or switched to wide keys
+	size_t bytes;     //memory held by all maps at the end of the load
+	size_t peakBytes; //most memory held by all maps at once, including while a map is resized
+} QOBJdedupStats;
+
+//options for loading a .obj file, start from qobj_default_load_options()
+typedef struct QOBJloadOptions
+{
+	uint32_t flags;      //bitfield of QOBJloadFlags
+	uint32_t numThreads; //maximum number of threads used with QOBJ_LOAD_PARALLEL, 0 to use one per core
+
+	float weldPosEpsilon;      //largest difference of each position component for QOBJ_LOAD_WELD to merge vertices
+	float weldNormalEpsilon;   //same, for each normal component
+	float weldTexCoordEpsilon; //same, for each tex coord component
+
+	uint32_t positionCap; //number of positions the position array starts with room for, unless the file was preflighted
+	uint32_t normalCap;   //same, for normals
+	uint32_t texCoordCap; //same, for tex coords
+	uint32_t vertexCap;   //number of vertices each mesh starts with room for, unless the file was preflighted
+	uint32_t indexCap;    //number of indices each mesh starts with room for, unless the file was preflighted
+	uint32_t mapCap;      //number of vertices each mesh's hashmap holds before growing, unless the file was preflighted
+	float growthFactor;   //how much a full buffer grows by, greater than 1 and at most QOBJ_MAX_GROWTH_FACTOR
+
+	QOBJcontext* context; //scratch memory reused across loads, NULL to allocate it for every load
+	QOBJdedupStats* stats; //filled in by the load if QOBJ_STATS is defined, may be NULL
+
+	const QOBJallocator* allocator; //allocates the results (and the scratch memory without a context), NULL to use QOBJ_MALLOC
+} QOBJloadOptions;
+
+//the largest QOBJloadOptions.growthFactor a load accepts
+#define QOBJ_MAX_GROWTH_FACTOR 8.0f
+
+//returns the options used when none are given
+QOBJloadOptions qobj_default_load_options(void);
+//creates a context that keeps the scratch memory of loads between calls, allocated with the given allocator (or the default if NULL)
+QOBJerror qobj_context_create(const QOBJallocator* allocator, QOBJcontext** context);
+//frees a context and all of the scratch memory it kept
+void qobj_context_free(QOBJcontext* context);
+
 //loads all meshes from a valid .obj file
 QOBJerror qobj_load_obj(const char* path, uint32_t* numMeshes, QOBJmesh** meshes);
+//loads all meshes from a valid .obj file, with the given options (or the defaults if NULL)
+QOBJerror qobj_load_obj_opts(const char* path, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes);
+//loads all meshes from a valid .obj file again, reusing the buffers of the meshes it replaces where they are large enough
+QOBJerror qobj_reload_obj(const char* path, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes);
+//loads all meshes from the contents of a .obj file that are already in memory
+QOBJerror qobj_load_obj_from_memory(const char* data, size_t len, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes);
+//loads all meshes from the contents of a .obj file, pulled through a user-supplied reader
+QOBJerror qobj_load_obj_ex(const QOBJreader* reader, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes);
 //frees all resources allocated from qobj_load_obj()
 void qobj_free_obj(uint32_t numMeshes, QOBJmesh* meshes);
+//frees all resources allocated from qobj_load_obj_opts() (or the other loads taking options), with the allocator in the options
+void qobj_free_obj_opts(uint32_t numMeshes, QOBJmesh* meshes, const QOBJloadOptions* options);
 
 //loads all materials from a valid .mtl file
 QOBJerror qobj_load_mtl(const char* path, uint32_t* numMaterials, QOBJmaterial** materials);
+//loads all materials from a valid .mtl file, with the allocator in the given options (or the default if NULL)
+QOBJerror qobj_load_mtl_opts(const char* path, const QOBJloadOptions* options, uint32_t* numMaterials, QOBJmaterial** materials);
+//loads all materials from the contents of a .mtl file that are already in memory
+QOBJerror qobj_load_mtl_from_memory(const char* data, size_t len, const QOBJloadOptions* options, uint32_t* numMaterials, QOBJmaterial** materials);
+//loads all materials from the contents of a .mtl file, pulled through a user-supplied reader
+QOBJerror qobj_load_mtl_ex(const QOBJreader* reader, const QOBJloadOptions* options, uint32_t* numMaterials, QOBJmaterial** materials);
 //frees all resources allocated from qobj_load_mtl()
 void qobj_free_mtl(uint32_t numMaterials, QOBJmaterial* materials);
+//frees all resources allocated from qobj_load_mtl_opts() (or the other loads taking options), with the allocator in the options
+void qobj_free_mtl_opts(uint32_t numMaterials, QOBJmaterial* materials, const QOBJloadOptions* options);
 
 //----------------------------------------------------------------------//
 
 #ifdef QOBJ_IMPLEMENTATION
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-#if !defined(QOBJ_MALLOC) || !defined(QOBJ_FREE) || !defined(QOBJ_FREE)
-	#include <malloc.h>
-
+#if !defined(QOBJ_MALLOC) || !defined(QOBJ_FREE) || !defined(QOBJ_REALLOC)
 	#define QOBJ_MALLOC(s) malloc(s)
 	#define QOBJ_FREE(p) free(p)
 	#define QOBJ_REALLOC(p, s) realloc(p, s)
 #endif
 
+#ifndef QOBJ_INLINE
+	#define QOBJ_INLINE static inline //internal helpers get no external definition, C99 and later need none for static ones
+#endif
+
+#if !defined(QOBJ_NO_SIMD)
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define QOBJ_SSE2
+		#include <emmintrin.h>
+	#endif
+
+	#if defined(__AVX2__)
+		#define QOBJ_AVX2
+		#include <immintrin.h>
+	#endif
+
+	#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+		#define QOBJ_NEON
+		#include <arm_neon.h>
+	#endif
+#endif
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+	#define QOBJ_PREFETCH(p) __builtin_prefetch(p)
+#elif defined(QOBJ_SSE2)
+	#define QOBJ_PREFETCH(p) _mm_prefetch((const char*)(p), _MM_HINT_T0)
+#else
+	#define QOBJ_PREFETCH(p)
+#endif
+
+#if !defined(_WIN32) && !defined(QOBJ_NO_MMAP)
+	#define QOBJ_MMAP
+
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#if !defined(_WIN32) && !defined(QOBJ_NO_THREADS)
+	#define QOBJ_THREADS
+
+	#include <pthread.h>
+	#include <unistd.h>
+#endif
+
+#define QOBJ_MAX_TOKEN_LEN 128
+
 #define QOBJ_ATTRIB_SIZE_POSITION   3
 #define QOBJ_ATTRIB_SIZE_NORMAL     3
 #define QOBJ_ATTRIB_SIZE_TEX_COORDS 2
@@ -184,6 +497,16 @@ void qobj_free_mtl(uint32_t numMaterials, QOBJmaterial* materials);
 //----------------------------------------------------------------------//
 //IMPLEMENTATION STRUCTS/ENUMS:
 
+#define QOBJ_FLOAT_MAX_DIGITS 768 //significant digits an exactly rounded float keeps, later ones only matter if any are nonzero
+#define QOBJ_BIGNUM_WORDS 128     //enough for any number qobj_parse_float_exact() compares, given the digits it keeps
+
+//an unsigned integer of up to QOBJ_BIGNUM_WORDS 32-bit words, used to round decimal floats exactly
+typedef struct QOBJbignum
+{
+	uint32_t numWords; //the most significant word is never 0
+	uint32_t words[QOBJ_BIGNUM_WORDS]; //least significant first
+} QOBJbignum;
+
 //a reference to a vertex (specified in the "f" command in an OBJ file)
 typedef struct QOBJvertexRef
 {
@@ -192,15 +515,96 @@ typedef struct QOBJvertexRef
 	uint32_t texCoord;
 } QOBJvertexRef;
 
+//a key/value pair stored in a QOBJvertexHashmap
+typedef struct QOBJvertexEntry
+{
+	QOBJvertexRef key;
+	uint32_t val;
+	uint32_t hash; //cached, so growing the map never rehashes keys and most tag collisions are rejected without comparing them
+} QOBJvertexEntry;
+
+//a key/value pair stored in a QOBJvertexHashmap with packed keys
+//the key is split in halves so the entry takes 12 bytes, its hash is cheap enough to recompute when the map grows
+typedef struct QOBJpackedVertexEntry
+{
+	uint32_t keyLo;
+	uint32_t keyHi;
+	uint32_t val;
+} QOBJpackedVertexEntry;
+
 //a hashmap with a vec3 of vertex data indices for keys
+//slots are split into groups of QOBJ_HASHMAP_GROUP_SIZE, each with a control byte per slot that holds QOBJ_HASHMAP_EMPTY or
+//the low 7 bits of the key's hash, so a whole group can be searched with a single SIMD compare before any key is read
 typedef struct QOBJvertexHashmap
 {
 	uint32_t size;
-	uint32_t cap;
-	QOBJvertexRef* keys; //an x component of UINT32_MAX signifies an unused index
-	uint32_t* vals;
+	uint32_t cap; //a power of 2, at least QOBJ_HASHMAP_GROUP_SIZE
+	uint8_t* ctrl;
+
+	int32_t packed; //if every key fits in 64 bits, see qobj_hashmap_pack(), only packedEntries is used
+	QOBJvertexEntry* entries;
+	QOBJpackedVertexEntry* packedEntries;
+
+	const QOBJallocator* allocator;
+
+#ifdef QOBJ_STATS
+	QOBJdedupStats* stats; //may be NULL
+#endif
 } QOBJvertexHashmap;
 
+//a run of consecutive indices that belong to the same mesh, used to split a shared index buffer between meshes
+typedef struct QOBJindexRun
+{
+	uint32_t mesh;
+	uint32_t end; //the run starts at the end of the previous one
+} QOBJindexRun;
+
+//the meshes of an earlier load, whose buffers are handed to the meshes of a reload instead of allocating new ones
+typedef struct QOBJrecycledMeshes
+{
+	uint32_t numMeshes;
+	QOBJmesh* meshes; //buffers are set to NULL once taken, the rest are freed after the reload
+} QOBJrecycledMeshes;
+
+//the state used to build a single mesh while loading
+typedef struct QOBJmeshBuilder
+{
+	uint32_t flags; //the QOBJloadFlags the mesh is loaded with
+
+	const QOBJallocator* allocator;     //allocates the builder's own buffers
+	const QOBJallocator* meshAllocator; //allocates the buffers of the mesh being built
+	float growthFactor;                 //how much the builder's and mesh's buffers grow by when full
+
+	QOBJvertexHashmap map; //used when deduplicating with a hashmap
+
+	uint32_t vertexRefCap;
+	QOBJvertexRef* vertexRefs; //what each of the mesh's vertices refers to, gathered into its vertices when finished (unused when sorting)
+
+	uint32_t numCorners;
+	uint32_t cornerCap;
+	QOBJvertexRef* corners; //triangle corners in face order, used when deduplicating by sorting (NULL otherwise)
+
+	uint32_t numRuns;
+	uint32_t runCap;
+	QOBJindexRun* runs; //the meshes faces belong to when the vertices are shared, in face order (NULL otherwise)
+} QOBJmeshBuilder;
+
+//scratch memory kept between loads, every buffer only grows
+struct QOBJcontext
+{
+	uint32_t positionCap;
+	uint32_t normalCap;
+	uint32_t texCoordCap;
+	float* positions;
+	float* normals;
+	float* texCoords;
+
+	uint32_t builderCap;
+	QOBJmeshBuilder* builders; //every builder holds the buffers of the last mesh built with it (or is zeroed)
+
+	QOBJallocator allocator; //allocates the context and everything it holds
+};
+
 //valid combinations of vertices a mesh can have, used for reading vertices in different formats
 typedef enum QOBJvertexSpecification
 {
@@ -210,408 +614,3579 @@ typedef enum QOBJvertexSpecification
 	QOBJ_VERTEX_SPEC_POSITION_TEX_COORD_NORMAL = QOBJ_VERTEX_ATTRIB_POSITION | QOBJ_VERTEX_ATTRIB_TEX_COORDS | QOBJ_VERTEX_ATTRIB_NORMAL,
 } QOBJvertexSpecification;
 
-//----------------------------------------------------------------------//
-//GENERAL HELPER FUNCTIONS:
+//keywords that can begin a line of a .obj file
+typedef enum QOBJobjKeyword
+{
+	QOBJ_OBJ_KEYWORD_NONE = 0, //blank line
+	QOBJ_OBJ_KEYWORD_UNKNOWN,
+	QOBJ_OBJ_KEYWORD_IGNORED,  //comments and commands that are skipped
+	QOBJ_OBJ_KEYWORD_V,
+	QOBJ_OBJ_KEYWORD_VN,
+	QOBJ_OBJ_KEYWORD_VT,
+	QOBJ_OBJ_KEYWORD_F,
+	QOBJ_OBJ_KEYWORD_USEMTL
+} QOBJobjKeyword;
+
+//keywords that can begin a line of a .mtl file
+typedef enum QOBJmtlKeyword
+{
+	QOBJ_MTL_KEYWORD_NONE = 0, //blank line
+	QOBJ_MTL_KEYWORD_UNKNOWN,
+	QOBJ_MTL_KEYWORD_IGNORED,  //comments and commands that are skipped
+	QOBJ_MTL_KEYWORD_NEWMTL,
+	QOBJ_MTL_KEYWORD_KA,
+	QOBJ_MTL_KEYWORD_KD,
+	QOBJ_MTL_KEYWORD_KS,
+	QOBJ_MTL_KEYWORD_D,
+	QOBJ_MTL_KEYWORD_NS,
+	QOBJ_MTL_KEYWORD_NI,
+	QOBJ_MTL_KEYWORD_MAP_KA,
+	QOBJ_MTL_KEYWORD_MAP_KD,
+	QOBJ_MTL_KEYWORD_MAP_KS,
+	QOBJ_MTL_KEYWORD_MAP_BUMP
+} QOBJmtlKeyword;
+
+//face counts for a single material, gathered by a preflight pass
+typedef struct QOBJpreflightMaterial
+{
+	char name[QOBJ_MAX_TOKEN_LEN];
+	uint32_t numIndices;
+	uint32_t numCorners;
+} QOBJpreflightMaterial;
 
-#define QOBJ_MAX_TOKEN_LEN 128
+//counts gathered by a preflight pass over a whole .obj file, used to allocate every buffer once
+typedef struct QOBJpreflight
+{
+	uint32_t numPositions;
+	uint32_t numNormals;
+	uint32_t numTexCoords;
 
-inline void qobj_next_token(FILE* fptr, char* token, char* endCh)
+	uint32_t numMaterials;
+	QOBJpreflightMaterial* materials;
+} QOBJpreflight;
+
+//a face read while loading in parallel, its corners are stored in its chunk's corner list
+typedef struct QOBJchunkFace
 {
-	char curCh;
-	uint32_t curLen = 0;
+	uint32_t spec;        //QOBJvertexSpecification shared by all corners
+	uint32_t material;    //index into the chunk's material names, or UINT32_MAX if the material was set before the chunk
+	uint32_t firstCorner;
+	uint32_t numCorners;
+} QOBJchunkFace;
+
+//a range of whole lines of a .obj file, parsed by a single thread when loading in parallel
+typedef struct QOBJchunk
+{
+	const char* start;
+	const char* end;
 
-	while(1)
-	{
-		if(curLen >= QOBJ_MAX_TOKEN_LEN)
-		{
-			curLen--;
-			break;
-		}
+	QOBJvertexRef counts;  //number of positions, normals and tex coords defined within the chunk
+	QOBJvertexRef offsets; //number of positions, normals and tex coords defined in all previous chunks
 
-		curCh = fgetc(fptr);
+	float* positions; //shared by all chunks, each one writes only its own range
+	float* normals;
+	float* texCoords;
 
-		if(isspace(curCh) || curCh == EOF)
-			break;
+	uint32_t numFaces;
+	uint32_t faceCap;
+	QOBJchunkFace* faces;
 
-		token[curLen++] = curCh;
-	}
+	uint32_t numCorners;
+	uint32_t cornerCap;
+	QOBJvertexRef* corners;
 
-	token[curLen] = '\0';
-	*endCh = curCh;
-}
+	uint32_t numMaterials;
+	uint32_t materialCap;
+	char* materials; //QOBJ_MAX_TOKEN_LEN chars per name, in the order "usemtl" appears
 
-inline void qobj_fgets(FILE* fptr, char* token, char* endCh)
+	const QOBJallocator* allocator; //allocates the chunk's lists
+	float growthFactor;             //how much the chunk's lists grow by when full
+	QOBJerror error;
+} QOBJchunk;
+
+//a memory-mapped file
+typedef struct QOBJfile
 {
-	fgets(token, QOBJ_MAX_TOKEN_LEN, fptr);
+	const char* data;
+	size_t len;
+} QOBJfile;
 
-	uint32_t last = (uint32_t)strlen(token) - 1;
-	if(token[last] == '\n')
-	{
-		*endCh = token[last];
-		token[last] = '\0';
-	}
-	else
-		*endCh = EOF;
-}
+#ifdef QOBJ_THREADS
 
-inline QOBJerror qobj_maybe_resize_array(void** buffer, size_t elemSize, uint32_t numElems, uint32_t* elemCap)
+//a block read ahead by a background thread, handed to the parsing thread when it next refills
+typedef struct QOBJprefetch
 {
-	if(numElems < *elemCap)
-		return QOBJ_SUCCESS;
-	
-	*elemCap *= 2;
-	void* newBuffer = QOBJ_REALLOC(*buffer, *elemCap * elemSize);
-	if(!newBuffer)
-		return QOBJ_ERROR_OUT_OF_MEM;
-	*buffer = newBuffer;
-
-	return QOBJ_SUCCESS;
-}
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+
+	const QOBJreader* reader;
+	const QOBJallocator* allocator;
+	char* block;
+	size_t blockCap;
+	size_t blockLen; //SIZE_MAX if the read failed
+	int32_t full;    //set by the background thread once [block] holds data, cleared by the parsing thread
+	int32_t stop;
+} QOBJprefetch;
+
+#endif //#ifdef QOBJ_THREADS
+
+//a view into the bytes being parsed, refilled from a reader if one is given
+typedef struct QOBJstream
+{
+	const char* cur;
+	const char* end;
+
+	const QOBJreader* reader; //NULL if all bytes are already in memory
+	const QOBJallocator* allocator; //allocates [buffer], NULL if all bytes are already in memory
+	char* buffer;
+	size_t bufferCap;
+	int32_t eof;
+	QOBJerror error;
+
+#ifdef QOBJ_THREADS
+	QOBJprefetch* prefetch; //NULL if blocks are read on the parsing thread
+#endif
+} QOBJstream;
 
 //----------------------------------------------------------------------//
-//HASH MAP FUNCTIONS:
+//ALLOCATOR FUNCTIONS:
 
-QOBJerror qobj_hashmap_create(QOBJvertexHashmap* map)
+void* qobj_default_alloc(void* user, size_t size)
 {
-	map->size = 0;
-	map->cap = 32;
-	map->keys = (QOBJvertexRef*)calloc(map->cap, sizeof(QOBJvertexRef));
-	if(!map->keys)
-		return QOBJ_ERROR_OUT_OF_MEM;
+	(void)user;
+	return QOBJ_MALLOC(size);
+}
 
-	map->vals = (uint32_t*)QOBJ_MALLOC(map->cap * sizeof(uint32_t));
-	if(!map->vals)
-	{
-		QOBJ_FREE(map->keys);
-		return QOBJ_ERROR_OUT_OF_MEM;
-	}
+void* qobj_default_realloc(void* user, void* ptr, size_t oldSize, size_t newSize)
+{
+	(void)user;
+	(void)oldSize;
+	return QOBJ_REALLOC(ptr, newSize);
+}
 
-	return QOBJ_SUCCESS;
+void qobj_default_free(void* user, void* ptr)
+{
+	(void)user;
+	QOBJ_FREE(ptr);
 }
 
-void qobj_hashmap_free(QOBJvertexHashmap map)
+//returns [allocator], or one that calls QOBJ_MALLOC, QOBJ_REALLOC and QOBJ_FREE if it is NULL
+const QOBJallocator* qobj_get_allocator(const QOBJallocator* allocator)
 {
-	QOBJ_FREE(map.keys);
-	QOBJ_FREE(map.vals);
+	static const QOBJallocator defaultAllocator = {qobj_default_alloc, qobj_default_realloc, qobj_default_free, NULL};
+	return allocator ? allocator : &defaultAllocator;
 }
 
-inline size_t qobj_hashmap_hash(QOBJvertexRef key)
+QOBJ_INLINE void* qobj_alloc(const QOBJallocator* allocator, size_t size)
 {
-	return 12637 * key.pos + 16369 * key.normal + 20749 * key.texCoord;
+	return allocator->allocFn(allocator->user, size);
 }
 
-QOBJerror qobj_hashmap_get_or_add(QOBJvertexHashmap* map, QOBJvertexRef key, uint32_t* val)
+//[oldSize] is the size [ptr] was allocated with, 0 if it is NULL
+QOBJ_INLINE void* qobj_realloc(const QOBJallocator* allocator, void* ptr, size_t oldSize, size_t newSize)
 {
-	//get hash:
-	//---------------
-	size_t hash = qobj_hashmap_hash(key) % map->cap;
+	return allocator->reallocFn(allocator->user, ptr, ptr ? oldSize : 0, newSize);
+}
 
-	//linear probing:
-	//---------------
-	int32_t found = 0;
-	while(map->keys[hash].pos != 0)
-	{		
-		if(map->keys[hash].pos == key.pos && map->keys[hash].normal == key.normal && map->keys[hash].texCoord == key.texCoord)
-		{
-			found = 1;
-			break;
-		}
+QOBJ_INLINE void qobj_free(const QOBJallocator* allocator, void* ptr)
+{
+	if(ptr)
+		allocator->freeFn(allocator->user, ptr);
+}
 
-		hash++;
-		hash %= map->cap;
-	}
+//----------------------------------------------------------------------//
+//STREAM FUNCTIONS:
 
-	if(found)
-		*val = map->vals[hash];
-	else
-	{
-		map->keys[hash] = key;
-		map->vals[hash] = *val;
-		map->size++;
-	}
+#ifndef QOBJ_READ_BLOCK_SIZE
+	#define QOBJ_READ_BLOCK_SIZE (1 << 20)
+#endif
 
-	//resize and rehash if needed:
-	//---------------
-	if(map->size >= map->cap / 2)
+#ifdef QOBJ_THREADS
+
+void* qobj_prefetch_thread(void* arg)
+{
+	QOBJprefetch* prefetch = (QOBJprefetch*)arg;
+
+	pthread_mutex_lock(&prefetch->mutex);
+	while(1)
 	{
-		uint32_t oldCap = map->cap;
-		map->cap *= 2;
+		while(prefetch->full && !prefetch->stop)
+			pthread_cond_wait(&prefetch->cond, &prefetch->mutex);
 
-		QOBJvertexRef* newKeys = (QOBJvertexRef*)calloc(map->cap, sizeof(QOBJvertexRef));
-		if(!newKeys)
-			return QOBJ_ERROR_OUT_OF_MEM;
-		uint32_t* newVals = (uint32_t*)QOBJ_MALLOC(map->cap * sizeof(uint32_t));
-		if(!newVals)
-		{
-			QOBJ_FREE(newKeys);
-			return QOBJ_ERROR_OUT_OF_MEM;
-		}
+		if(prefetch->stop)
+			break;
 
-		for(uint32_t i = 0; i < oldCap; i++)
-		{
-			if(map->keys[i].pos == 0)
-				continue;
+		//read without holding the lock, so the parsing thread is never blocked by the reader:
+		//---------------
+		pthread_mutex_unlock(&prefetch->mutex);
+		size_t numRead = prefetch->reader->read(prefetch->reader->user, prefetch->block, prefetch->blockCap);
+		pthread_mutex_lock(&prefetch->mutex);
 
-			size_t newHash = qobj_hashmap_hash(map->keys[i]) % map->cap;
-			newKeys[newHash] = map->keys[i];
-			newVals[newHash] = map->vals[i];
-		}
+		prefetch->blockLen = numRead;
+		prefetch->full = 1;
+		pthread_cond_broadcast(&prefetch->cond);
 
-		QOBJ_FREE(map->keys);
-		QOBJ_FREE(map->vals);
-		map->keys = newKeys;
-		map->vals = newVals;
+		if(numRead == 0 || numRead == SIZE_MAX)
+			break;
 	}
+	pthread_mutex_unlock(&prefetch->mutex);
 
-	return QOBJ_SUCCESS;
+	return NULL;
 }
 
-//----------------------------------------------------------------------//
-//MESH FUNCTIONS
-
-QOBJerror qobj_mesh_create(QOBJmesh* mesh, uint32_t vertexAttribs, const char* materialName)
+//starts reading blocks of [blockCap] bytes from [reader] on a background thread, returns NULL if it could not be started
+QOBJprefetch* qobj_prefetch_start(const QOBJreader* reader, size_t blockCap, const QOBJallocator* allocator)
 {
-	//determine strides and offsets of attributes:
-	//---------------
-	mesh->vertexAttribs = vertexAttribs;
-	mesh->vertexStride = 0;
+	QOBJprefetch* prefetch = (QOBJprefetch*)qobj_alloc(allocator, sizeof(QOBJprefetch));
+	if(!prefetch)
+		return NULL;
 
-	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_POSITION)
+	prefetch->block = (char*)qobj_alloc(allocator, blockCap);
+	if(!prefetch->block)
 	{
-		mesh->vertexPosOffset = mesh->vertexStride;
-		mesh->vertexStride += QOBJ_ATTRIB_SIZE_POSITION;
+		qobj_free(allocator, prefetch);
+		return NULL;
 	}
-	else
-		mesh->vertexPosOffset = UINT32_MAX;
 
-	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_NORMAL)
-	{
-		mesh->vertexNormalOffset = mesh->vertexStride;
-		mesh->vertexStride += QOBJ_ATTRIB_SIZE_NORMAL;
-	}
-	else
-		mesh->vertexNormalOffset = UINT32_MAX;
-	
-	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_TEX_COORDS)
+	prefetch->reader = reader;
+	prefetch->allocator = allocator;
+	prefetch->blockCap = blockCap;
+	prefetch->blockLen = 0;
+	prefetch->full = 0;
+	prefetch->stop = 0;
+
+	pthread_mutex_init(&prefetch->mutex, NULL);
+	pthread_cond_init(&prefetch->cond, NULL);
+
+	if(pthread_create(&prefetch->thread, NULL, qobj_prefetch_thread, prefetch) != 0)
 	{
-		mesh->vertexTexCoordOffset = mesh->vertexStride;
-		mesh->vertexStride += QOBJ_ATTRIB_SIZE_TEX_COORDS;
+		pthread_mutex_destroy(&prefetch->mutex);
+		pthread_cond_destroy(&prefetch->cond);
+
+		qobj_free(allocator, prefetch->block);
+		qobj_free(allocator, prefetch);
+		return NULL;
 	}
-	else
-		mesh->vertexTexCoordOffset = UINT32_MAX;
 
-	//allocate data:
-	//---------------
-	mesh->vertexCap   = 32;
-	mesh->indexCap    = 32;
-	mesh->numVertices = 0;
-	mesh->numIndices  = 0;
+	return prefetch;
+}
 
-	mesh->vertices = (float*)QOBJ_MALLOC(mesh->vertexCap * sizeof(float) * mesh->vertexStride);
-	if(!mesh->vertices)
-		return QOBJ_ERROR_OUT_OF_MEM;
+void qobj_prefetch_stop(QOBJprefetch* prefetch)
+{
+	pthread_mutex_lock(&prefetch->mutex);
+	prefetch->stop = 1;
+	pthread_cond_broadcast(&prefetch->cond);
+	pthread_mutex_unlock(&prefetch->mutex);
+
+	pthread_join(prefetch->thread, NULL);
+
+	pthread_mutex_destroy(&prefetch->mutex);
+	pthread_cond_destroy(&prefetch->cond);
+
+	const QOBJallocator* allocator = prefetch->allocator;
+	qobj_free(allocator, prefetch->block);
+	qobj_free(allocator, prefetch);
+}
+
+#endif //#ifdef QOBJ_THREADS
+
+void qobj_stream_from_memory(QOBJstream* stream, const char* data, size_t len)
+{
+	stream->cur = data;
+	stream->end = data + len;
+
+	stream->reader = NULL;
+	stream->allocator = NULL;
+	stream->buffer = NULL;
+	stream->bufferCap = 0;
+	stream->eof = 1;
+	stream->error = QOBJ_SUCCESS;
+
+#ifdef QOBJ_THREADS
+	stream->prefetch = NULL;
+#endif
+}
 
-	mesh->indices = (uint32_t*)QOBJ_MALLOC(mesh->indexCap * sizeof(uint32_t));
-	if(!mesh->indices)
+//if [pipelined] is set, blocks are read on a background thread when threads are available
+QOBJerror qobj_stream_from_reader(QOBJstream* stream, const QOBJreader* reader, int32_t pipelined, const QOBJallocator* allocator)
+{
+	//size blocks to hold the whole input if it is smaller than one:
+	//---------------
+	size_t blockCap = QOBJ_READ_BLOCK_SIZE;
+	if(reader->size)
 	{
-		QOBJ_FREE(mesh->vertices);
-		return QOBJ_ERROR_OUT_OF_MEM;
+		size_t totalSize = reader->size(reader->user);
+		if(totalSize < blockCap)
+			blockCap = totalSize + 1;
 	}
 
-	//copy material name:
+	//start reading ahead if requested, the buffer then needs room for a whole block after any unparsed bytes:
 	//---------------
-	uint32_t nameSize = (uint32_t)strlen(materialName) + 1;
-	mesh->material = (char*)QOBJ_MALLOC(nameSize);
-	if(!mesh->material)
+	size_t bufferCap = blockCap;
+
+#ifdef QOBJ_THREADS
+	stream->prefetch = pipelined ? qobj_prefetch_start(reader, blockCap, allocator) : NULL;
+	if(stream->prefetch)
+		bufferCap = blockCap * 2;
+#else
+	(void)pipelined;
+#endif
+
+	stream->buffer = (char*)qobj_alloc(allocator, bufferCap);
+	if(!stream->buffer)
 	{
-		QOBJ_FREE(mesh->vertices);
-		QOBJ_FREE(mesh->indices);
+	#ifdef QOBJ_THREADS
+		if(stream->prefetch)
+			qobj_prefetch_stop(stream->prefetch);
+	#endif
+
 		return QOBJ_ERROR_OUT_OF_MEM;
 	}
 
-	strcpy_s(mesh->material, nameSize, materialName);
+	stream->cur = stream->buffer;
+	stream->end = stream->buffer;
+
+	stream->reader = reader;
+	stream->allocator = allocator;
+	stream->bufferCap = bufferCap;
+	stream->eof = 0;
+	stream->error = QOBJ_SUCCESS;
 
 	return QOBJ_SUCCESS;
 }
 
-void qobj_mesh_free(QOBJmesh mesh)
+void qobj_stream_free(QOBJstream* stream)
 {
-	QOBJ_FREE(mesh.vertices);
-	QOBJ_FREE(mesh.indices);
-	QOBJ_FREE(mesh.material);
-}
+#ifdef QOBJ_THREADS
+	if(stream->prefetch)
+		qobj_prefetch_stop(stream->prefetch);
+#endif
 
-//----------------------------------------------------------------------//
-//MATERIAL FUNCTIONS:
+	if(stream->buffer)
+		qobj_free(stream->allocator, stream->buffer);
+}
 
-QOBJmaterial qobj_default_material()
+//grows the buffer until it can hold [needed] bytes, returns 0 if out of memory
+int32_t qobj_stream_reserve(QOBJstream* stream, size_t needed)
 {
-	QOBJmaterial result = {0};
+	while(stream->bufferCap < needed)
+	{
+		char* newBuffer = (char*)qobj_realloc(stream->allocator, stream->buffer, stream->bufferCap, stream->bufferCap * 2);
+		if(!newBuffer)
+		{
+			stream->error = QOBJ_ERROR_OUT_OF_MEM;
+			return 0;
+		}
 
-	result.opacity = 1.0f;
-	result.specularExp = 1.0f;
-	result.refractionIndex = 1.0f;
+		stream->buffer = newBuffer;
+		stream->bufferCap *= 2;
+	}
 
-	return result;
+	return 1;
 }
 
-void qobj_material_free(QOBJmaterial material)
+//reads the next block directly into the buffer after [remaining] unparsed bytes, returns the number of bytes read
+size_t qobj_stream_read(QOBJstream* stream, size_t remaining)
 {
-	if(material.name)
-		QOBJ_FREE(material.name);
+	//grow buffer if a single line fills all of it
+	if(!qobj_stream_reserve(stream, remaining + 1))
+		return 0;
+
+	size_t numRead = stream->reader->read(stream->reader->user, stream->buffer + remaining, stream->bufferCap - remaining);
+	if(numRead == SIZE_MAX)
+	{
+		stream->error = QOBJ_ERROR_IO;
+		return 0;
+	}
 
-	if(material.ambientMapPath)
-		QOBJ_FREE(material.ambientMapPath);
-	if(material.diffuseMapPath)
-		QOBJ_FREE(material.diffuseMapPath);
-	if(material.specularMapPath)
-		QOBJ_FREE(material.specularMapPath);
-	if(material.normalMapPath)
-		QOBJ_FREE(material.normalMapPath);
+	return numRead;
 }
 
-//----------------------------------------------------------------------//
-//VERTEX HELPER FUNCTION:
+#ifdef QOBJ_THREADS
 
-inline int32_t qobj_read_vertex_ref(FILE* fptr, QOBJvertexSpecification spec, QOBJvertexRef* vert)
+//waits for the block read by the background thread and copies it after [remaining] unparsed bytes, returns the number of bytes read
+size_t qobj_stream_take_prefetched(QOBJstream* stream, size_t remaining)
 {
-	int32_t numRead;
+	QOBJprefetch* prefetch = stream->prefetch;
 
-	switch(spec)
-	{
-	case QOBJ_VERTEX_SPEC_POSITION:
-	{
-		numRead = fscanf_s(fptr, "%d", &vert->pos);
-		vert->texCoord = 0;
-		vert->normal = 0;
-		break;
-	}
-	case QOBJ_VERTEX_SPEC_POSITION_TEX_COORD:
-	{
-		numRead = fscanf_s(fptr, "%d/%d", &vert->pos, &vert->texCoord);
-		vert->normal = 0;
-		break;
-	}
-	case QOBJ_VERTEX_SPEC_POSITION_NORMAL:
-	{
-		numRead = fscanf_s(fptr, "%d//%d", &vert->pos, &vert->normal);
-		vert->texCoord = 0;
-		break;
-	}
-	case QOBJ_VERTEX_SPEC_POSITION_TEX_COORD_NORMAL:
+	pthread_mutex_lock(&prefetch->mutex);
+	while(!prefetch->full)
+		pthread_cond_wait(&prefetch->cond, &prefetch->mutex);
+	size_t numRead = prefetch->blockLen;
+	pthread_mutex_unlock(&prefetch->mutex);
+
+	if(numRead == SIZE_MAX)
 	{
-		numRead = fscanf_s(fptr, "%d/%d/%d", &vert->pos, &vert->texCoord, &vert->normal);
-		break;
-	}
+		stream->error = QOBJ_ERROR_IO;
+		return 0;
 	}
 
+	if(numRead == 0 || !qobj_stream_reserve(stream, remaining + numRead))
+		return 0;
+
+	memcpy(stream->buffer + remaining, prefetch->block, numRead);
+
+	//let the background thread start on the next block:
+	//---------------
+	pthread_mutex_lock(&prefetch->mutex);
+	prefetch->full = 0;
+	pthread_cond_broadcast(&prefetch->cond);
+	pthread_mutex_unlock(&prefetch->mutex);
+
 	return numRead;
 }
 
-inline void qobj_add_vertex(QOBJmesh* mesh, QOBJvertexHashmap* map, QOBJvertexRef vert,
-                            float* positions, float* texCoords, float* normals)
-{
-	uint32_t indexToAdd = (uint32_t)mesh->numVertices;
-	qobj_hashmap_get_or_add(map, vert, &indexToAdd);
+#endif //#ifdef QOBJ_THREADS
 
-	mesh->indices[mesh->numIndices++] = indexToAdd;
-	if(indexToAdd < (uint32_t)mesh->numVertices) //skip if vertex already exists in mesh
-		return;
+//moves unparsed bytes to the front of the buffer and reads a new block after them, returns 0 if nothing more could be read
+int32_t qobj_stream_refill(QOBJstream* stream)
+{
+	size_t remaining = stream->end - stream->cur;
+	memmove(stream->buffer, stream->cur, remaining);
 
+	size_t numRead;
+#ifdef QOBJ_THREADS
+	if(stream->prefetch)
+		numRead = qobj_stream_take_prefetched(stream, remaining);
+	else
+#endif
+		numRead = qobj_stream_read(stream, remaining);
+
+	if(numRead == 0)
+		stream->eof = 1;
+
+	stream->cur = stream->buffer;
+	stream->end = stream->buffer + remaining + numRead;
+
+	return numRead > 0;
+}
+
+//----------------------------------------------------------------------//
+//SCANNING FUNCTIONS:
+
+//matches the characters isspace() accepts in the "C" locale, without a locale lookup
+QOBJ_INLINE int32_t qobj_is_space(char ch)
+{
+	return ch == ' ' || (uint32_t)(ch - '\t') <= (uint32_t)('\r' - '\t');
+}
+
+QOBJ_INLINE void qobj_skip_space(const char** cur, const char* end)
+{
+	while(*cur < end && qobj_is_space(**cur))
+		(*cur)++;
+}
+
+QOBJ_INLINE uint32_t qobj_count_trailing_zeros(uint64_t mask)
+{
+#ifdef _MSC_VER
+	unsigned long idx;
+	#if defined(_M_X64) || defined(_M_ARM64)
+		_BitScanForward64(&idx, mask);
+	#else
+		if(!_BitScanForward(&idx, (uint32_t)mask))
+		{
+			_BitScanForward(&idx, (uint32_t)(mask >> 32));
+			idx += 32;
+		}
+	#endif
+	return (uint32_t)idx;
+#else
+	return (uint32_t)__builtin_ctzll(mask);
+#endif
+}
+
+//returns a pointer to the first '\n' in [str, end), or NULL if there is none
+//full blocks are compared 32 (AVX2) or 16 (SSE2/NEON) bytes at a time, so skipping long lines costs very little
+QOBJ_INLINE const char* qobj_find_newline(const char* str, const char* end)
+{
+#if defined(QOBJ_AVX2)
+	const __m256i newlines256 = _mm256_set1_epi8('\n');
+	for(; end - str >= 32; str += 32)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i*)str);
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newlines256));
+		if(mask)
+			return str + qobj_count_trailing_zeros(mask);
+	}
+#endif
+
+#if defined(QOBJ_SSE2)
+	const __m128i newlines = _mm_set1_epi8('\n');
+	for(; end - str >= 16; str += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*)str);
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newlines));
+		if(mask)
+			return str + qobj_count_trailing_zeros(mask);
+	}
+#elif defined(QOBJ_NEON)
+	const uint8x16_t newlines = vdupq_n_u8('\n');
+	for(; end - str >= 16; str += 16)
+	{
+		uint8x16_t matches = vceqq_u8(vld1q_u8((const uint8_t*)str), newlines);
+
+		//narrow each 8-bit lane result to 4 bits, giving a 64-bit mask
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+		if(mask)
+			return str + (qobj_count_trailing_zeros(mask) >> 2);
+	}
+#endif
+
+	return (const char*)memchr(str, '\n', end - str);
+}
+
+//----------------------------------------------------------------------//
+//GENERAL HELPER FUNCTIONS:
+
+QOBJ_INLINE int32_t qobj_next_line(QOBJstream* stream, const char** lineStart, const char** lineEnd)
+{
+	const char* newline = qobj_find_newline(stream->cur, stream->end);
+	while(!newline && stream->reader && !stream->eof) //line continues past the buffered data, pull in more
+	{
+		size_t searched = stream->end - stream->cur;
+		if(!qobj_stream_refill(stream))
+			break;
+
+		newline = qobj_find_newline(stream->cur + searched, stream->end);
+	}
+
+	if(stream->cur >= stream->end)
+		return 0;
+
+	*lineStart = stream->cur;
+
+	if(newline)
+	{
+		*lineEnd = newline;
+		stream->cur = newline + 1;
+	}
+	else
+	{
+		*lineEnd = stream->end;
+		stream->cur = stream->end;
+	}
+
+	return 1;
+}
+
+QOBJ_INLINE uint32_t qobj_next_token(const char** cur, const char* end, char* token)
+{
+	qobj_skip_space(cur, end);
+
+	uint32_t curLen = 0;
+	while(*cur < end && !qobj_is_space(**cur))
+	{
+		if(curLen < QOBJ_MAX_TOKEN_LEN - 1)
+			token[curLen++] = **cur;
+
+		(*cur)++;
+	}
+
+	token[curLen] = '\0';
+	return curLen;
+}
+
+QOBJ_INLINE void qobj_rest_of_line(const char** cur, const char* end, char* token)
+{
+	qobj_skip_space(cur, end);
+
+	const char* last = end;
+	while(last > *cur && qobj_is_space(*(last - 1)))
+		last--;
+
+	uint32_t curLen = (uint32_t)(last - *cur);
+	if(curLen > QOBJ_MAX_TOKEN_LEN - 1)
+		curLen = QOBJ_MAX_TOKEN_LEN - 1;
+
+	memcpy(token, *cur, curLen);
+	token[curLen] = '\0';
+	*cur = end;
+}
+
+//returns 10^[exp], exactly for [exp] <= 22
+QOBJ_INLINE double qobj_pow10(uint32_t exp)
+{
+	static const double powersOf10[] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	double result = 1.0;
+	for(; exp > 22; exp -= 22)
+		result *= 1e22;
+
+	return result * powersOf10[exp];
+}
+
+QOBJ_INLINE float qobj_float_from_bits(uint32_t bits)
+{
+	float result;
+	memcpy(&result, &bits, sizeof(float));
+	return result;
+}
+
+QOBJ_INLINE uint32_t qobj_float_to_bits(float val)
+{
+	uint32_t bits;
+	memcpy(&bits, &val, sizeof(float));
+	return bits;
+}
+
+//sets [num] to [val]
+QOBJ_INLINE void qobj_bignum_set(QOBJbignum* num, uint64_t val)
+{
+	num->numWords = 0;
+	for(; val != 0; val >>= 32)
+		num->words[num->numWords++] = (uint32_t)val;
+}
+
+//sets [num] to [num] * [factor] + [add], returns 0 if the result does not fit
+QOBJ_INLINE int32_t qobj_bignum_mul_add(QOBJbignum* num, uint32_t factor, uint32_t add)
+{
+	uint64_t carry = add;
+	for(uint32_t i = 0; i < num->numWords; i++)
+	{
+		uint64_t product = (uint64_t)num->words[i] * factor + carry;
+		num->words[i] = (uint32_t)product;
+		carry = product >> 32;
+	}
+
+	if(carry != 0)
+	{
+		if(num->numWords == QOBJ_BIGNUM_WORDS)
+			return 0;
+
+		num->words[num->numWords++] = (uint32_t)carry;
+	}
+
+	return 1;
+}
+
+//sets [num] to [num] * 10^[exp], returns 0 if the result does not fit
+QOBJ_INLINE int32_t qobj_bignum_mul_pow10(QOBJbignum* num, uint32_t exp)
+{
+	static const uint32_t powersOf10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+	for(; exp > 9; exp -= 9)
+	{
+		if(!qobj_bignum_mul_add(num, powersOf10[9], 0))
+			return 0;
+	}
+
+	return qobj_bignum_mul_add(num, powersOf10[exp], 0);
+}
+
+//sets [num] to [num] * 2^[shift], returns 0 if the result does not fit
+QOBJ_INLINE int32_t qobj_bignum_shift(QOBJbignum* num, uint32_t shift)
+{
+	if(num->numWords == 0)
+		return 1;
+
+	uint32_t wordShift = shift / 32;
+	uint32_t bitShift = shift % 32;
+	if(num->numWords + wordShift + 1 > QOBJ_BIGNUM_WORDS)
+		return 0;
+
+	//move words up from the top, so no word is overwritten before it is moved:
+	//---------------
+	num->words[num->numWords + wordShift] = 0;
+	for(uint32_t i = num->numWords; i-- > 0;)
+	{
+		uint32_t word = num->words[i];
+		if(bitShift != 0)
+			num->words[i + wordShift + 1] |= word >> (32 - bitShift);
+
+		num->words[i + wordShift] = word << bitShift;
+	}
+
+	memset(num->words, 0, wordShift * sizeof(uint32_t));
+
+	num->numWords += wordShift + 1;
+	if(num->words[num->numWords - 1] == 0)
+		num->numWords--;
+
+	return 1;
+}
+
+//returns -1, 0, or 1 if [a] is less than, equal to, or greater than [b]
+QOBJ_INLINE int32_t qobj_bignum_compare(const QOBJbignum* a, const QOBJbignum* b)
+{
+	if(a->numWords != b->numWords)
+		return a->numWords < b->numWords ? -1 : 1;
+
+	for(uint32_t i = a->numWords; i-- > 0;)
+	{
+		if(a->words[i] != b->words[i])
+			return a->words[i] < b->words[i] ? -1 : 1;
+	}
+
+	return 0;
+}
+
+//parses "inf", "infinity", or "nan" (optionally followed by "(chars)") in any case, starting at [cur] (after the sign)
+//returns the number of bytes consumed, 0 if there is neither
+QOBJ_INLINE uint32_t qobj_parse_float_special(const char* cur, const char* end, float* val)
+{
+	static const char* const names[] = {"infinity", "inf", "nan"};
+
+	for(uint32_t i = 0; i < 3; i++)
+	{
+		uint32_t len = 0;
+		while(names[i][len] != '\0' && cur + len < end && (cur[len] | 0x20) == names[i][len])
+			len++;
+
+		if(names[i][len] != '\0')
+			continue;
+
+		*val = qobj_float_from_bits(i < 2 ? 0x7F800000 : 0x7FC00000);
+
+		if(i == 2 && cur + len < end && cur[len] == '(')
+		{
+			uint32_t parenLen = len + 1;
+			while(cur + parenLen < end && (cur[parenLen] == '_' || (uint32_t)((cur[parenLen] | 0x20) - 'a') < 26 || (uint32_t)(cur[parenLen] - '0') < 10))
+				parenLen++;
+
+			if(cur + parenLen < end && cur[parenLen] == ')')
+				len = parenLen + 1;
+		}
+
+		return len;
+	}
+
+	return 0;
+}
+
+//returns the float nearest to the decimal number in [str, end) (digits [. digits] [e [sign] digits], without a sign), ties to even
+//used for any input the fast path in qobj_parse_float() cannot round exactly. the number is approximated in double, and only
+//compared exactly against the midpoint of the two floats around it when the approximation is too close to the midpoint to tell
+QOBJ_INLINE float qobj_parse_float_exact(const char* str, const char* end)
+{
+	//gather significant digits, the number is [digits] * 10^[exponent]:
+	//---------------
+	uint8_t digits[QOBJ_FLOAT_MAX_DIGITS];
+	uint32_t numDigits = 0;
+	int32_t truncated = 0; //whether any nonzero digits were dropped
+	int32_t exponent = 0;
+
+	int32_t fraction = 0;
+	for(; str < end; str++)
+	{
+		if(*str == '.')
+		{
+			fraction = 1;
+			continue;
+		}
+
+		uint32_t digit = (uint32_t)(*str - '0');
+		if(digit >= 10)
+			break;
+
+		if(numDigits == 0 && digit == 0) //leading zeros
+			exponent -= fraction;
+		else if(numDigits < QOBJ_FLOAT_MAX_DIGITS)
+		{
+			digits[numDigits++] = (uint8_t)digit;
+			exponent -= fraction;
+		}
+		else
+		{
+			truncated |= (digit != 0);
+			exponent += !fraction;
+		}
+	}
+
+	if(str < end && (*str == 'e' || *str == 'E'))
+	{
+		str++;
+
+		int32_t expNegative = (*str == '-');
+		if(*str == '-' || *str == '+')
+			str++;
+
+		int32_t explicitExp = 0;
+		for(; str < end; str++)
+		{
+			if(explicitExp < 100000)
+				explicitExp = explicitExp * 10 + (*str - '0');
+		}
+
+		exponent += expNegative ? -explicitExp : explicitExp;
+	}
+
+	//the number is at least 10^(magnitude - 1) and less than 10^magnitude:
+	//---------------
+	int32_t magnitude = (int32_t)numDigits + exponent;
+	if(numDigits == 0 || magnitude < -46) //less than half the smallest float
+		return 0.0f;
+	if(magnitude > 39) //larger than the largest float
+		return qobj_float_from_bits(0x7F800000);
+
+	//approximate in double from the first 19 digits, within 2^-50 of the number, and find the floats around it:
+	//---------------
+	uint32_t numApproxDigits = numDigits < 19 ? numDigits : 19;
+
+	uint64_t approxMantissa = 0;
+	for(uint32_t i = 0; i < numApproxDigits; i++)
+		approxMantissa = approxMantissa * 10 + digits[i];
+
+	int32_t approxExponent = exponent + (int32_t)(numDigits - numApproxDigits);
+	double approx = (double)approxMantissa;
+	if(approxExponent < 0)
+		approx /= qobj_pow10((uint32_t)-approxExponent);
+	else
+		approx *= qobj_pow10((uint32_t)approxExponent);
+
+	uint32_t lowBits = qobj_float_to_bits((float)approx);
+	if((double)qobj_float_from_bits(lowBits) > approx)
+		lowBits--;
+
+	float low = qobj_float_from_bits(lowBits);
+	float high = qobj_float_from_bits(lowBits + 1); //infinity after the largest float
+
+	double ulp = lowBits + 1 == 0x7F800000 ? (double)low - (double)qobj_float_from_bits(lowBits - 1) : (double)high - (double)low;
+	double mid = (double)low + ulp * 0.5;
+
+	double tolerance = mid * (1.0 / 281474976710656.0); //2^-48, a few times the approximation's error
+	if(approx < mid - tolerance)
+		return low;
+	if(approx > mid + tolerance)
+		return high;
+
+	//compare the number exactly against the midpoint, which is [midMantissa] * 2^[midExponent]:
+	//---------------
+	uint64_t midBits;
+	memcpy(&midBits, &mid, sizeof(double));
+
+	uint64_t midMantissa = (midBits & (((uint64_t)1 << 52) - 1)) | ((uint64_t)1 << 52);
+	int32_t midExponent = (int32_t)((midBits >> 52) & 0x7FF) - 1075;
+
+	QOBJbignum number, midpoint;
+	qobj_bignum_set(&number, 0);
+	qobj_bignum_set(&midpoint, midMantissa);
+
+	int32_t fits = 1;
+	for(uint32_t i = 0; i < numDigits; i++)
+		fits &= qobj_bignum_mul_add(&number, 10, digits[i]);
+
+	if(exponent > 0)
+		fits &= qobj_bignum_mul_pow10(&number, (uint32_t)exponent);
+	else
+		fits &= qobj_bignum_mul_pow10(&midpoint, (uint32_t)-exponent);
+
+	if(midExponent > 0)
+		fits &= qobj_bignum_shift(&midpoint, (uint32_t)midExponent);
+	else
+		fits &= qobj_bignum_shift(&number, (uint32_t)-midExponent);
+
+	if(!fits) //can not happen with the digits kept, QOBJ_BIGNUM_WORDS has room to spare
+		return (float)approx;
+
+	int32_t comparison = qobj_bignum_compare(&number, &midpoint);
+	if(comparison == 0 && truncated)
+		comparison = 1;
+
+	if(comparison < 0)
+		return low;
+	if(comparison > 0)
+		return high;
+
+	return (lowBits & 1) ? high : low;
+}
+
+//parses a decimal float ([sign] digits [. digits] [e [sign] digits]) starting at [cur], returns 0 if there is no number
+//results are correctly rounded, matching strtof() in the "C" locale whatever the current locale is
+QOBJ_INLINE int32_t qobj_parse_float(const char** cur, const char* end, float* val)
+{
+	const char* str = *cur;
+
+	//sign:
+	//---------------
+	int32_t negative = 0;
+	if(str < end && (*str == '-' || *str == '+'))
+	{
+		negative = (*str == '-');
+		str++;
+	}
+
+	//mantissa digits, before and after the decimal point:
+	//---------------
+	uint64_t mantissa = 0;
+	int32_t numDigits = 0;
+	int32_t exponent = 0;
+
+	const char* digitsStart = str;
+	while(str < end && (uint32_t)(*str - '0') < 10)
+	{
+		mantissa = mantissa * 10 + (uint64_t)(*str - '0');
+		numDigits += (mantissa != 0); //leading zeros are not significant
+		str++;
+	}
+
+	if(str < end && *str == '.')
+	{
+		str++;
+		while(str < end && (uint32_t)(*str - '0') < 10)
+		{
+			mantissa = mantissa * 10 + (uint64_t)(*str - '0');
+			numDigits += (mantissa != 0);
+			exponent--;
+			str++;
+		}
+	}
+
+	if(str == digitsStart || (str == digitsStart + 1 && *digitsStart == '.')) //no digits, may be inf/nan
+	{
+		uint32_t len = qobj_parse_float_special(digitsStart, end, val);
+		if(len == 0)
+			return 0;
+
+		*val = negative ? -*val : *val;
+		*cur = digitsStart + len;
+		return 1;
+	}
+
+	//exponent:
+	//---------------
+	if(str < end && (*str == 'e' || *str == 'E'))
+	{
+		const char* expStart = str++;
+
+		int32_t expNegative = 0;
+		if(str < end && (*str == '-' || *str == '+'))
+		{
+			expNegative = (*str == '-');
+			str++;
+		}
+
+		if(str < end && (uint32_t)(*str - '0') < 10)
+		{
+			int32_t explicitExp = 0;
+			while(str < end && (uint32_t)(*str - '0') < 10)
+			{
+				if(explicitExp < 100000)
+					explicitExp = explicitExp * 10 + (*str - '0');
+				str++;
+			}
+
+			exponent += expNegative ? -explicitExp : explicitExp;
+		}
+		else
+			str = expStart; //"e" not followed by digits is not part of the number
+	}
+
+	//compute value, falling back to the exact parser if it may not be exact:
+	//---------------
+	//mantissa and 10^exponent are both exact doubles, so a single multiply/divide rounds correctly
+	int32_t exact = !(numDigits > 19 || mantissa > ((uint64_t)1 << 53) || exponent < -22 || exponent > 22);
+
+	double value = (double)mantissa;
+	if(exact && exponent < 0)
+		value /= qobj_pow10((uint32_t)-exponent);
+	else if(exact)
+		value *= qobj_pow10((uint32_t)exponent);
+
+	//rounding the double to a float is only ambiguous if it lies exactly halfway between two floats,
+	//or if the result is subnormal or overflows
+	if(value != 0.0)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(double));
+
+		uint32_t biasedExp = (uint32_t)(bits >> 52) & 0x7FF;
+		if((bits & 0x1FFFFFFF) == 0x10000000 || biasedExp <= 1023 - 127 || biasedExp >= 1023 + 128)
+			exact = 0;
+	}
+
+	float result = exact ? (float)value : qobj_parse_float_exact(digitsStart, str);
+
+	*val = negative ? -result : result;
+	*cur = str;
+	return 1;
+}
+
+QOBJ_INLINE uint32_t qobj_read_floats(const char** cur, const char* end, float* vals, uint32_t count)
+{
+	uint32_t numRead = 0;
+	for(; numRead < count; numRead++)
+	{
+		qobj_skip_space(cur, end);
+
+		if(!qobj_parse_float(cur, end, &vals[numRead]))
+			break;
+	}
+
+	for(uint32_t i = numRead; i < count; i++) //missing components default to 0
+		vals[i] = 0.0f;
+
+	return numRead;
+}
+
+//grows [buffer] by [growthFactor], as many times as needed, once it has no room left past [numElems]
+//a capacity the factor does not grow (such as 0) grows by 1 instead, so growth always ends
+QOBJ_INLINE QOBJerror qobj_maybe_resize_array(void** buffer, size_t elemSize, uint32_t numElems, uint32_t* elemCap, float growthFactor,
+                                              const QOBJallocator* allocator)
+{
+	if(numElems < *elemCap)
+		return QOBJ_SUCCESS;
+
+	uint64_t newCap = *elemCap;
+	while(newCap <= numElems)
+	{
+		double grownCap = (double)newCap * growthFactor;
+		if(grownCap >= (double)UINT32_MAX)
+		{
+			newCap = UINT32_MAX;
+			break;
+		}
+
+		newCap = (uint64_t)grownCap > newCap ? (uint64_t)grownCap : newCap + 1;
+	}
+
+	void* newBuffer = qobj_realloc(allocator, *buffer, *elemCap * elemSize, (size_t)newCap * elemSize);
+	if(!newBuffer)
+		return QOBJ_ERROR_OUT_OF_MEM;
+	*buffer = newBuffer;
+	*elemCap = (uint32_t)newCap;
+
+	return QOBJ_SUCCESS;
+}
+
+//grows [buffer] to exactly [numElems] if it has room for fewer, its contents are kept
+QOBJ_INLINE QOBJerror qobj_reserve_array(void** buffer, size_t elemSize, uint32_t numElems, uint32_t* elemCap, const QOBJallocator* allocator)
+{
+	if(numElems <= *elemCap)
+		return QOBJ_SUCCESS;
+
+	void* newBuffer = qobj_realloc(allocator, *buffer, *elemCap * elemSize, numElems * elemSize);
+	if(!newBuffer)
+		return QOBJ_ERROR_OUT_OF_MEM;
+	*buffer = newBuffer;
+	*elemCap = numElems;
+
+	return QOBJ_SUCCESS;
+}
+
+//shrinks [buffer] to exactly [numElems] if it has room for more, a buffer that can not be shrunk is kept as it is
+QOBJ_INLINE void qobj_shrink_array(void** buffer, size_t elemSize, uint32_t numElems, uint32_t* elemCap, const QOBJallocator* allocator)
+{
+	if(numElems == 0 || numElems >= *elemCap)
+		return;
+
+	void* newBuffer = qobj_realloc(allocator, *buffer, *elemCap * elemSize, numElems * elemSize);
+	if(!newBuffer)
+		return;
+	*buffer = newBuffer;
+	*elemCap = numElems;
+}
+
+//----------------------------------------------------------------------//
+//KEYWORD FUNCTIONS:
+
+//reads the keyword at the start of a line, returns its length (0 for a blank line)
+QOBJ_INLINE uint32_t qobj_read_keyword(const char** cur, const char* end, const char** keyword)
+{
+	qobj_skip_space(cur, end);
+
+	*keyword = *cur;
+	while(*cur < end && !qobj_is_space(**cur))
+		(*cur)++;
+
+	return (uint32_t)(*cur - *keyword);
+}
+
+//classifies a .obj keyword by its first byte and length, so each line takes a couple of branches instead of a chain of strcmp()s
+QOBJ_INLINE QOBJobjKeyword qobj_read_obj_keyword(const char** cur, const char* end)
+{
+	const char* keyword;
+	uint32_t len = qobj_read_keyword(cur, end, &keyword);
+	if(len == 0)
+		return QOBJ_OBJ_KEYWORD_NONE;
+
+	switch(keyword[0])
+	{
+	case 'v':
+	{
+		if(len == 1)
+			return QOBJ_OBJ_KEYWORD_V;
+		else if(len == 2 && keyword[1] == 'n')
+			return QOBJ_OBJ_KEYWORD_VN;
+		else if(len == 2 && keyword[1] == 't')
+			return QOBJ_OBJ_KEYWORD_VT;
+
+		break;
+	}
+	case 'f':
+	{
+		if(len == 1)
+			return QOBJ_OBJ_KEYWORD_F;
+
+		break;
+	}
+	case '#':
+		return QOBJ_OBJ_KEYWORD_IGNORED;
+	case 'o':
+	case 'g':
+	case 's':
+	{
+		if(len == 1)
+			return QOBJ_OBJ_KEYWORD_IGNORED;
+
+		break;
+	}
+	case 'm':
+	{
+		if(len == 6 && memcmp(keyword, "mtllib", 6) == 0)
+			return QOBJ_OBJ_KEYWORD_IGNORED;
+
+		break;
+	}
+	case 'u':
+	{
+		if(len == 6 && memcmp(keyword, "usemtl", 6) == 0)
+			return QOBJ_OBJ_KEYWORD_USEMTL;
+
+		break;
+	}
+	}
+
+	return QOBJ_OBJ_KEYWORD_UNKNOWN;
+}
+
+//classifies a .mtl keyword by its first byte and length
+QOBJ_INLINE QOBJmtlKeyword qobj_read_mtl_keyword(const char** cur, const char* end)
+{
+	const char* keyword;
+	uint32_t len = qobj_read_keyword(cur, end, &keyword);
+	if(len == 0)
+		return QOBJ_MTL_KEYWORD_NONE;
+
+	switch(keyword[0])
+	{
+	case 'K':
+	{
+		if(len != 2)
+			break;
+
+		if(keyword[1] == 'a')
+			return QOBJ_MTL_KEYWORD_KA;
+		else if(keyword[1] == 'd')
+			return QOBJ_MTL_KEYWORD_KD;
+		else if(keyword[1] == 's')
+			return QOBJ_MTL_KEYWORD_KS;
+
+		break;
+	}
+	case 'N':
+	{
+		if(len != 2)
+			break;
+
+		if(keyword[1] == 's')
+			return QOBJ_MTL_KEYWORD_NS;
+		else if(keyword[1] == 'i')
+			return QOBJ_MTL_KEYWORD_NI;
+
+		break;
+	}
+	case 'd':
+	{
+		if(len == 1)
+			return QOBJ_MTL_KEYWORD_D;
+
+		break;
+	}
+	case 'n':
+	{
+		if(len == 6 && memcmp(keyword, "newmtl", 6) == 0)
+			return QOBJ_MTL_KEYWORD_NEWMTL;
+
+		break;
+	}
+	case 'm':
+	{
+		if(len == 6 && memcmp(keyword, "map_K", 5) == 0)
+		{
+			if(keyword[5] == 'a')
+				return QOBJ_MTL_KEYWORD_MAP_KA;
+			else if(keyword[5] == 'd')
+				return QOBJ_MTL_KEYWORD_MAP_KD;
+			else if(keyword[5] == 's')
+				return QOBJ_MTL_KEYWORD_MAP_KS;
+		}
+		else if(len == 8 && memcmp(keyword, "map_Bump", 8) == 0)
+			return QOBJ_MTL_KEYWORD_MAP_BUMP;
+
+		break;
+	}
+	case '#':
+		return QOBJ_MTL_KEYWORD_IGNORED;
+	case 'i':
+	{
+		if(len == 5 && memcmp(keyword, "illum", 5) == 0)
+			return QOBJ_MTL_KEYWORD_IGNORED;
+
+		break;
+	}
+	case 'T':
+	{
+		if(len == 2 && keyword[1] == 'f')
+			return QOBJ_MTL_KEYWORD_IGNORED;
+
+		break;
+	}
+	}
+
+	return QOBJ_MTL_KEYWORD_UNKNOWN;
+}
+
+//----------------------------------------------------------------------//
+//FILE FUNCTIONS:
+
+FILE* qobj_file_open(const char* path)
+{
+	FILE* fptr;
+#ifdef _MSC_VER
+	if(fopen_s(&fptr, path, "rb") != 0)
+		return NULL;
+#else
+	fptr = fopen(path, "rb");
+#endif
+
+	return fptr;
+}
+
+size_t qobj_file_read(void* user, char* buf, size_t len)
+{
+	FILE* fptr = (FILE*)user;
+
+	size_t numRead = fread(buf, 1, len, fptr);
+	if(numRead == 0 && ferror(fptr))
+		return SIZE_MAX;
+
+	return numRead;
+}
+
+QOBJreader qobj_file_reader(FILE* fptr)
+{
+	QOBJreader reader;
+	reader.read = qobj_file_read;
+	reader.size = NULL;
+	reader.user = fptr;
+
+	return reader;
+}
+
+#ifdef QOBJ_MMAP
+
+QOBJerror qobj_file_map(const char* path, QOBJfile* file)
+{
+	int fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return QOBJ_ERROR_IO;
+
+	//only regular, non-empty files can be mapped:
+	//---------------
+	struct stat fileStat;
+	if(fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size <= 0)
+	{
+		close(fd);
+		return QOBJ_ERROR_IO;
+	}
+
+	void* data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); //the mapping stays valid after the descriptor is closed
+
+	if(data == MAP_FAILED)
+		return QOBJ_ERROR_IO;
+
+	//the hint is only declared if the includer's feature macros expose POSIX 2001, which strict C99/C11 modes do not:
+	#ifdef POSIX_MADV_SEQUENTIAL
+		posix_madvise(data, (size_t)fileStat.st_size, POSIX_MADV_SEQUENTIAL);
+	#endif
+
+	file->data = (const char*)data;
+	file->len = (size_t)fileStat.st_size;
+
+	return QOBJ_SUCCESS;
+}
+
+void qobj_file_unmap(QOBJfile file)
+{
+	munmap((void*)file.data, file.len);
+}
+
+#endif //#ifdef QOBJ_MMAP
+
+//----------------------------------------------------------------------//
+//HASH MAP FUNCTIONS:
+
+#define QOBJ_HASHMAP_GROUP_SIZE 16
+#define QOBJ_HASHMAP_EMPTY 0x80
+
+//the map grows once more than 7/8 of its slots are full
+#define QOBJ_HASHMAP_MAX_SIZE(cap) ((cap) - (cap) / 8)
+
+//keys are packed into a single uint64_t while every index fits in this many bits
+#define QOBJ_HASHMAP_PACKED_BITS 21
+
+//NEON compares produce 4 mask bits per slot, SSE2 and the scalar fallback produce 1
+#if defined(QOBJ_NEON) && !defined(QOBJ_SSE2)
+	#define QOBJ_HASHMAP_MASK_BITS 4
+#else
+	#define QOBJ_HASHMAP_MASK_BITS 1
+#endif
+
+#ifdef QOBJ_STATS
+
+//adds [bytes] to the memory held by maps
+QOBJ_INLINE void qobj_stats_add_bytes(QOBJdedupStats* stats, size_t bytes)
+{
+	if(!stats)
+		return;
+
+	stats->bytes += bytes;
+	if(stats->bytes > stats->peakBytes)
+		stats->peakBytes = stats->bytes;
+}
+
+//computes the statistics derived from the counts once a load is done
+QOBJ_INLINE void qobj_stats_finish(QOBJdedupStats* stats)
+{
+	if(stats && stats->lookups > 0)
+		stats->meanProbes = (double)stats->totalProbes / (double)stats->lookups;
+}
+
+QOBJ_INLINE void qobj_stats_lookup(QOBJdedupStats* stats, uint32_t numProbes, int32_t hit)
+{
+	if(!stats)
+		return;
+
+	stats->lookups++;
+	stats->hits += hit ? 1 : 0;
+	stats->totalProbes += numProbes;
+	if(numProbes > stats->maxProbes)
+		stats->maxProbes = numProbes;
+}
+
+#endif //#ifdef QOBJ_STATS
+
+//returns a mask with QOBJ_HASHMAP_MASK_BITS set for every control byte in [group] equal to [val]
+QOBJ_INLINE uint64_t qobj_hashmap_match(const uint8_t* group, uint8_t val)
+{
+#if defined(QOBJ_SSE2)
+	__m128i matches = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)group), _mm_set1_epi8((char)val));
+	return (uint64_t)(uint32_t)_mm_movemask_epi8(matches);
+#elif defined(QOBJ_NEON)
+	uint8x16_t matches = vceqq_u8(vld1q_u8(group), vdupq_n_u8(val));
+	return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+#else
+	uint64_t mask = 0;
+	for(uint32_t i = 0; i < QOBJ_HASHMAP_GROUP_SIZE; i++)
+		mask |= (uint64_t)(group[i] == val) << i;
+
+	return mask;
+#endif
+}
+
+QOBJerror qobj_hashmap_create(QOBJvertexHashmap* map, uint32_t cap, int32_t packed, const QOBJallocator* allocator)
+{
+	if(cap < QOBJ_HASHMAP_GROUP_SIZE)
+		cap = QOBJ_HASHMAP_GROUP_SIZE;
+
+	map->size = 0;
+	map->cap = cap;
+	map->packed = packed;
+	map->entries = NULL;
+	map->packedEntries = NULL;
+	map->allocator = allocator;
+#ifdef QOBJ_STATS
+	map->stats = NULL;
+#endif
+	map->ctrl = (uint8_t*)qobj_alloc(allocator, map->cap);
+	if(!map->ctrl)
+		return QOBJ_ERROR_OUT_OF_MEM;
+
+	if(packed)
+		map->packedEntries = (QOBJpackedVertexEntry*)qobj_alloc(allocator, map->cap * sizeof(QOBJpackedVertexEntry));
+	else
+		map->entries = (QOBJvertexEntry*)qobj_alloc(allocator, map->cap * sizeof(QOBJvertexEntry));
+
+	if(!map->entries && !map->packedEntries)
+	{
+		qobj_free(allocator, map->ctrl);
+		map->ctrl = NULL;
+		return QOBJ_ERROR_OUT_OF_MEM;
+	}
+
+	memset(map->ctrl, QOBJ_HASHMAP_EMPTY, map->cap);
+
+	return QOBJ_SUCCESS;
+}
+
+void qobj_hashmap_free(QOBJvertexHashmap map)
+{
+	qobj_free(map.allocator, map.ctrl);
+	qobj_free(map.allocator, map.entries);
+	qobj_free(map.allocator, map.packedEntries);
+}
+
+//returns the memory held by [map]
+QOBJ_INLINE size_t qobj_hashmap_bytes(const QOBJvertexHashmap* map)
+{
+	return (size_t)map->cap * (1 + (map->packed ? sizeof(QOBJpackedVertexEntry) : sizeof(QOBJvertexEntry)));
+}
+
+//empties [map], keeping its memory
+void qobj_hashmap_clear(QOBJvertexHashmap* map)
+{
+	map->size = 0;
+	memset(map->ctrl, QOBJ_HASHMAP_EMPTY, map->cap);
+}
+
+//packs [key] into [packed] and returns 1 if each of its indices fits in QOBJ_HASHMAP_PACKED_BITS, otherwise returns 0
+QOBJ_INLINE int32_t qobj_hashmap_pack(QOBJvertexRef key, uint64_t* packed)
+{
+	if((key.pos | key.normal | key.texCoord) >> QOBJ_HASHMAP_PACKED_BITS)
+		return 0;
+
+	*packed = (uint64_t)key.pos | (uint64_t)key.normal << QOBJ_HASHMAP_PACKED_BITS | (uint64_t)key.texCoord << (QOBJ_HASHMAP_PACKED_BITS * 2);
+	return 1;
+}
+
+QOBJ_INLINE QOBJvertexRef qobj_hashmap_unpack(uint64_t packed)
+{
+	uint64_t mask = ((uint64_t)1 << QOBJ_HASHMAP_PACKED_BITS) - 1;
+
+	QOBJvertexRef key;
+	key.pos = (uint32_t)(packed & mask);
+	key.normal = (uint32_t)((packed >> QOBJ_HASHMAP_PACKED_BITS) & mask);
+	key.texCoord = (uint32_t)(packed >> (QOBJ_HASHMAP_PACKED_BITS * 2));
+
+	return key;
+}
+
+QOBJ_INLINE uint64_t qobj_hashmap_packed_key(const QOBJpackedVertexEntry* entry)
+{
+	return (uint64_t)entry->keyHi << 32 | entry->keyLo;
+}
+
+//mixes all bits of [hash] into every bit of the result, so regular index patterns (grids, strides) do not cluster
+QOBJ_INLINE uint32_t qobj_hashmap_mix(uint64_t hash)
+{
+	//64-bit finalizer from MurmurHash3:
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ull;
+	hash ^= hash >> 33;
+
+	return (uint32_t)hash;
+}
+
+QOBJ_INLINE uint32_t qobj_hashmap_hash(QOBJvertexRef key)
+{
+	return qobj_hashmap_mix(((uint64_t)key.pos << 32 | key.normal) ^ ((uint64_t)key.texCoord * 0x9E3779B97F4A7C15ull));
+}
+
+//returns the slot holding [key] (or [packedKey] if the map is packed), or the empty slot it should be inserted into
+//groups are probed in a triangular sequence, which visits every group once when the number of groups is a power of 2
+//[numProbes] is set to the number of groups searched, it is optimized out when unused
+QOBJ_INLINE uint32_t qobj_hashmap_find(const QOBJvertexHashmap* map, QOBJvertexRef key, uint64_t packedKey, uint32_t hash, int32_t* found, uint32_t* numProbes)
+{
+	uint8_t tag = (uint8_t)(hash & 0x7F);
+	uint32_t groupMask = map->cap / QOBJ_HASHMAP_GROUP_SIZE - 1;
+	uint32_t group = (hash >> 7) & groupMask;
+
+	for(uint32_t step = 1; ; step++)
+	{
+		const uint8_t* ctrl = &map->ctrl[group * QOBJ_HASHMAP_GROUP_SIZE];
+
+		//compare keys only in slots whose tag matches:
+		//---------------
+		uint64_t matches = qobj_hashmap_match(ctrl, tag);
+		while(matches)
+		{
+			uint32_t slot = group * QOBJ_HASHMAP_GROUP_SIZE + qobj_count_trailing_zeros(matches) / QOBJ_HASHMAP_MASK_BITS;
+
+			int32_t equal;
+			if(map->packed)
+				equal = qobj_hashmap_packed_key(&map->packedEntries[slot]) == packedKey;
+			else
+			{
+				const QOBJvertexEntry* entry = &map->entries[slot];
+				equal = entry->hash == hash && entry->key.pos == key.pos && entry->key.normal == key.normal && entry->key.texCoord == key.texCoord;
+			}
+
+			if(equal)
+			{
+				*found = 1;
+				*numProbes = step;
+				return slot;
+			}
+
+			matches &= ~((((uint64_t)1 << QOBJ_HASHMAP_MASK_BITS) - 1) << (slot % QOBJ_HASHMAP_GROUP_SIZE * QOBJ_HASHMAP_MASK_BITS));
+		}
+
+		//entries are never removed, so an empty slot ends the search:
+		//---------------
+		uint64_t empty = qobj_hashmap_match(ctrl, QOBJ_HASHMAP_EMPTY);
+		if(empty)
+		{
+			*found = 0;
+			*numProbes = step;
+			return group * QOBJ_HASHMAP_GROUP_SIZE + qobj_count_trailing_zeros(empty) / QOBJ_HASHMAP_MASK_BITS;
+		}
+
+		group = (group + step) & groupMask;
+	}
+}
+
+//moves every entry into a new map with [newCap] slots, also converts packed keys to wide ones if [packed] is 0
+QOBJerror qobj_hashmap_resize(QOBJvertexHashmap* map, uint32_t newCap, int32_t packed)
+{
+	QOBJvertexHashmap newMap;
+	QOBJerror createError = qobj_hashmap_create(&newMap, newCap, packed, map->allocator);
+	if(createError != QOBJ_SUCCESS)
+		return createError;
+
+	for(uint32_t i = 0; i < map->cap; i++)
+	{
+		if(map->ctrl[i] == QOBJ_HASHMAP_EMPTY)
+			continue;
+
+		//get the entry's hash in the new map:
+		//---------------
+		QOBJvertexRef key = {0, 0, 0};
+		uint32_t hash;
+		if(!map->packed)
+			hash = map->entries[i].hash;
+		else if(packed)
+			hash = qobj_hashmap_mix(qobj_hashmap_packed_key(&map->packedEntries[i]));
+		else
+		{
+			key = qobj_hashmap_unpack(qobj_hashmap_packed_key(&map->packedEntries[i]));
+			hash = qobj_hashmap_hash(key);
+		}
+
+		//keys are unique, so only an empty slot needs to be found:
+		//---------------
+		uint32_t groupMask = newMap.cap / QOBJ_HASHMAP_GROUP_SIZE - 1;
+		uint32_t group = (hash >> 7) & groupMask;
+
+		uint64_t empty;
+		for(uint32_t step = 1; !(empty = qobj_hashmap_match(&newMap.ctrl[group * QOBJ_HASHMAP_GROUP_SIZE], QOBJ_HASHMAP_EMPTY)); step++)
+			group = (group + step) & groupMask;
+
+		uint32_t slot = group * QOBJ_HASHMAP_GROUP_SIZE + qobj_count_trailing_zeros(empty) / QOBJ_HASHMAP_MASK_BITS;
+
+		newMap.ctrl[slot] = (uint8_t)(hash & 0x7F);
+		if(packed)
+			newMap.packedEntries[slot] = map->packedEntries[i];
+		else if(map->packed)
+		{
+			newMap.entries[slot].key = key;
+			newMap.entries[slot].val = map->packedEntries[i].val;
+			newMap.entries[slot].hash = hash;
+		}
+		else
+			newMap.entries[slot] = map->entries[i];
+	}
+
+	newMap.size = map->size;
+
+#ifdef QOBJ_STATS
+	newMap.stats = map->stats;
+	if(map->stats)
+	{
+		map->stats->resizes++;
+		qobj_stats_add_bytes(map->stats, qobj_hashmap_bytes(&newMap)); //the old map is still held
+		map->stats->bytes -= qobj_hashmap_bytes(map);
+	}
+#endif
+
+	qobj_hashmap_free(*map);
+	*map = newMap;
+
+	return QOBJ_SUCCESS;
+}
+
+//if [key] is in the map, sets [val] to its value, otherwise adds it with the value [val]
+QOBJerror qobj_hashmap_get_or_add(QOBJvertexHashmap* map, QOBJvertexRef key, uint32_t* val)
+{
+	//switch to wide keys the first time a key does not fit in a packed one:
+	//---------------
+	uint64_t packedKey = 0;
+	if(map->packed && !qobj_hashmap_pack(key, &packedKey))
+	{
+		QOBJerror resizeError = qobj_hashmap_resize(map, map->cap, 0);
+		if(resizeError != QOBJ_SUCCESS)
+			return resizeError;
+	}
+
+	uint32_t hash = map->packed ? qobj_hashmap_mix(packedKey) : qobj_hashmap_hash(key);
+
+	int32_t found;
+	uint32_t numProbes;
+	uint32_t slot = qobj_hashmap_find(map, key, packedKey, hash, &found, &numProbes);
+
+#ifdef QOBJ_STATS
+	qobj_stats_lookup(map->stats, numProbes, found);
+#endif
+
+	if(found)
+	{
+		*val = map->packed ? map->packedEntries[slot].val : map->entries[slot].val;
+		return QOBJ_SUCCESS;
+	}
+
+	//grow before inserting, so the map always keeps an empty slot to end searches:
+	//---------------
+	if(map->size + 1 > QOBJ_HASHMAP_MAX_SIZE(map->cap))
+	{
+		QOBJerror resizeError = qobj_hashmap_resize(map, map->cap * 2, map->packed);
+		if(resizeError != QOBJ_SUCCESS)
+			return resizeError;
+
+		slot = qobj_hashmap_find(map, key, packedKey, hash, &found, &numProbes);
+	}
+
+	map->ctrl[slot] = (uint8_t)(hash & 0x7F);
+	if(map->packed)
+	{
+		map->packedEntries[slot].keyLo = (uint32_t)packedKey;
+		map->packedEntries[slot].keyHi = (uint32_t)(packedKey >> 32);
+		map->packedEntries[slot].val = *val;
+	}
+	else
+	{
+		map->entries[slot].key = key;
+		map->entries[slot].val = *val;
+		map->entries[slot].hash = hash;
+	}
+	map->size++;
+
+	return QOBJ_SUCCESS;
+}
+
+//----------------------------------------------------------------------//
+//MESH FUNCTIONS
+
+//determines the stride and attribute offsets of vertices with [vertexAttribs]
+void qobj_mesh_layout(QOBJmesh* mesh, uint32_t vertexAttribs)
+{
+	mesh->vertexAttribs = vertexAttribs;
+	mesh->vertexStride = 0;
+
+	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_POSITION)
+	{
+		mesh->vertexPosOffset = mesh->vertexStride;
+		mesh->vertexStride += QOBJ_ATTRIB_SIZE_POSITION;
+	}
+	else
+		mesh->vertexPosOffset = UINT32_MAX;
+
+	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_NORMAL)
+	{
+		mesh->vertexNormalOffset = mesh->vertexStride;
+		mesh->vertexStride += QOBJ_ATTRIB_SIZE_NORMAL;
+	}
+	else
+		mesh->vertexNormalOffset = UINT32_MAX;
+	
+	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_TEX_COORDS)
+	{
+		mesh->vertexTexCoordOffset = mesh->vertexStride;
+		mesh->vertexStride += QOBJ_ATTRIB_SIZE_TEX_COORDS;
+	}
+	else
+		mesh->vertexTexCoordOffset = UINT32_MAX;
+}
+
+//widens the layout of [mesh] to also hold [vertexAttribs], used when the vertices are shared and a later face has more attributes
+//a recycled vertex buffer is dropped when the layout changes, as its capacity counts vertices of the old stride
+void qobj_mesh_widen(QOBJmesh* mesh, uint32_t vertexAttribs, const QOBJallocator* allocator)
+{
+	if((mesh->vertexAttribs | vertexAttribs) == mesh->vertexAttribs)
+		return;
+
+	qobj_mesh_layout(mesh, mesh->vertexAttribs | vertexAttribs);
+
+	qobj_free(allocator, mesh->vertices);
+	mesh->vertices = NULL;
+	mesh->vertexCap = 0;
+}
+
+void qobj_mesh_free(QOBJmesh mesh, const QOBJallocator* allocator)
+{
+	qobj_free(allocator, mesh.vertices);
+	qobj_free(allocator, mesh.indices);
+	qobj_free(allocator, mesh.material);
+}
+
+//creates [mesh], taking the buffers of [recycled] (may be NULL) instead of allocating when they are large enough
+QOBJerror qobj_mesh_create(QOBJmesh* mesh, uint32_t vertexAttribs, const char* materialName, uint32_t indexCap, QOBJmesh* recycled,
+                           const QOBJallocator* allocator)
+{
+	qobj_mesh_layout(mesh, vertexAttribs);
+
+	mesh->vertexCap   = 0;
+	mesh->indexCap    = 0;
+	mesh->numVertices = 0;
+	mesh->numIndices  = 0;
+	mesh->firstIndex  = 0;
+
+	mesh->vertices = NULL;
+	mesh->indices = NULL;
+	mesh->material = NULL;
+	mesh->block = NULL;
+
+	//take recycled buffers, vertices are only kept if their capacity means the same with this mesh's stride:
+	//---------------
+	if(recycled)
+	{
+		if(recycled->vertexStride == mesh->vertexStride)
+		{
+			mesh->vertices = recycled->vertices;
+			mesh->vertexCap = recycled->vertexCap;
+		}
+		else
+			qobj_free(allocator, recycled->vertices);
+
+		recycled->vertices = NULL;
+
+		if(indexCap > 0)
+		{
+			mesh->indices = recycled->indices;
+			mesh->indexCap = recycled->indexCap;
+			recycled->indices = NULL;
+		}
+
+		if(recycled->material && strcmp(recycled->material, materialName) == 0)
+		{
+			mesh->material = recycled->material;
+			recycled->material = NULL;
+		}
+	}
+
+	//allocate data, vertices are only allocated once they are gathered:
+	//---------------
+	if(qobj_reserve_array((void**)&mesh->indices, sizeof(uint32_t), indexCap, &mesh->indexCap, allocator) != QOBJ_SUCCESS)
+	{
+		qobj_mesh_free(*mesh, allocator);
+		return QOBJ_ERROR_OUT_OF_MEM;
+	}
+
+	//copy material name:
+	//---------------
+	if(mesh->material)
+		return QOBJ_SUCCESS;
+
+	uint32_t nameSize = (uint32_t)strlen(materialName) + 1;
+	mesh->material = (char*)qobj_alloc(allocator, nameSize);
+	if(!mesh->material)
+	{
+		qobj_mesh_free(*mesh, allocator);
+		return QOBJ_ERROR_OUT_OF_MEM;
+	}
+
+	memcpy(mesh->material, materialName, nameSize);
+
+	return QOBJ_SUCCESS;
+}
+
+//frees every mesh's buffers and then the array, with QOBJ_LOAD_SHARED_VERTICES the shared buffers are owned by the first mesh
+void qobj_meshes_free(uint32_t numMeshes, QOBJmesh* meshes, const QOBJallocator* allocator)
+{
+	for(uint32_t i = 0; i < numMeshes; i++)
+	{
+		if(i > 0 && meshes[i].vertices && meshes[i].vertices == meshes[0].vertices)
+			qobj_free(allocator, meshes[i].material);
+		else
+			qobj_mesh_free(meshes[i], allocator);
+	}
+
+	qobj_free(allocator, meshes);
+}
+
+//shrinks every mesh's vertices and indices to exactly their size, with QOBJ_LOAD_SHARED_VERTICES the shared buffers are
+//owned by the first mesh, and the other meshes are pointed at them again as shrinking may move them
+void qobj_meshes_shrink(uint32_t numMeshes, QOBJmesh* meshes, int32_t shared, const QOBJallocator* allocator)
+{
+	uint32_t numBuffers = shared ? 1 : numMeshes;
+	for(uint32_t i = 0; i < numBuffers; i++)
+	{
+		QOBJmesh* mesh = &meshes[i];
+
+		uint32_t numIndices = mesh->numIndices;
+		for(uint32_t j = 1; j < numMeshes && shared; j++)
+			numIndices += meshes[j].numIndices;
+
+		qobj_shrink_array((void**)&mesh->vertices, sizeof(float) * mesh->vertexStride, mesh->numVertices, &mesh->vertexCap, allocator);
+		qobj_shrink_array((void**)&mesh->indices, sizeof(uint32_t), numIndices, &mesh->indexCap, allocator);
+	}
+
+	for(uint32_t i = 1; i < numMeshes && shared; i++)
+	{
+		meshes[i].vertices = meshes[0].vertices;
+		meshes[i].vertexCap = meshes[0].vertexCap;
+		meshes[i].indices = &meshes[0].indices[meshes[i].firstIndex];
+	}
+}
+
+//returns the recycled mesh with [material] if it still holds buffers, otherwise any that does, or NULL if there is none
+QOBJmesh* qobj_recycled_find(QOBJrecycledMeshes* recycled, const char* material)
+{
+	if(!recycled)
+		return NULL;
+
+	QOBJmesh* any = NULL;
+	for(uint32_t i = 0; i < recycled->numMeshes; i++)
+	{
+		QOBJmesh* mesh = &recycled->meshes[i];
+		if(!mesh->vertices && !mesh->indices)
+			continue;
+
+		if(mesh->material && strcmp(mesh->material, material) == 0)
+			return mesh;
+		if(!any)
+			any = mesh;
+	}
+
+	return any;
+}
+
+//every buffer in a QOBJ_LOAD_SINGLE_BLOCK block starts a multiple of this many bytes into it
+#define QOBJ_BLOCK_ALIGNMENT 16
+
+QOBJ_INLINE size_t qobj_block_align(size_t size)
+{
+	return (size + QOBJ_BLOCK_ALIGNMENT - 1) & ~(size_t)(QOBJ_BLOCK_ALIGNMENT - 1);
+}
+
+//moves the mesh array and all of its meshes' vertices, indices, and material names into one block, which replaces [meshes]
+//the block holds the mesh array first, then the vertices, then the indices, then the names. [meshes] is untouched on failure
+QOBJerror qobj_meshes_pack(uint32_t numMeshes, QOBJmesh** meshes, int32_t shared, const QOBJallocator* allocator)
+{
+	QOBJmesh* oldMeshes = *meshes;
+	uint32_t numBuffers = shared ? 1 : numMeshes; //shared meshes all point into the first mesh's buffers
+
+	//measure every part of the block:
+	//---------------
+	uint32_t sharedIndices = 0;
+	for(uint32_t i = 0; i < numMeshes; i++)
+		sharedIndices += oldMeshes[i].numIndices;
+
+	size_t size = qobj_block_align(numMeshes * sizeof(QOBJmesh));
+	for(uint32_t i = 0; i < numBuffers; i++)
+		size += qobj_block_align((size_t)oldMeshes[i].numVertices * oldMeshes[i].vertexStride * sizeof(float));
+	for(uint32_t i = 0; i < numBuffers; i++)
+		size += qobj_block_align((size_t)(shared ? sharedIndices : oldMeshes[i].numIndices) * sizeof(uint32_t));
+	for(uint32_t i = 0; i < numMeshes; i++)
+		size += strlen(oldMeshes[i].material) + 1;
+
+	char* block = (char*)qobj_alloc(allocator, size);
+	if(!block)
+		return QOBJ_ERROR_OUT_OF_MEM;
+
+	//copy meshes, then their buffers:
+	//---------------
+	QOBJmesh* newMeshes = (QOBJmesh*)block;
+	memcpy(newMeshes, oldMeshes, numMeshes * sizeof(QOBJmesh));
+
+	char* cur = block + qobj_block_align(numMeshes * sizeof(QOBJmesh));
+	for(uint32_t i = 0; i < numBuffers; i++)
+	{
+		size_t vertexSize = (size_t)oldMeshes[i].numVertices * oldMeshes[i].vertexStride * sizeof(float);
+		newMeshes[i].vertices = oldMeshes[i].vertices ? (float*)cur : NULL;
+		newMeshes[i].vertexCap = oldMeshes[i].numVertices;
+		if(vertexSize > 0)
+			memcpy(cur, oldMeshes[i].vertices, vertexSize);
+
+		cur += qobj_block_align(vertexSize);
+	}
+
+	for(uint32_t i = 0; i < numBuffers; i++)
+	{
+		uint32_t numIndices = shared ? sharedIndices : oldMeshes[i].numIndices;
+		newMeshes[i].indices = oldMeshes[i].indices ? (uint32_t*)cur : NULL;
+		newMeshes[i].indexCap = numIndices;
+		if(numIndices > 0)
+			memcpy(cur, oldMeshes[i].indices, numIndices * sizeof(uint32_t));
+
+		cur += qobj_block_align(numIndices * sizeof(uint32_t));
+	}
+
+	for(uint32_t i = 0; i < numMeshes; i++)
+		newMeshes[i].block = block;
+
+	for(uint32_t i = 1; i < numMeshes && shared; i++)
+	{
+		newMeshes[i].vertices = newMeshes[0].vertices;
+		newMeshes[i].vertexCap = newMeshes[0].vertexCap;
+		newMeshes[i].indices = newMeshes[0].indices ? &newMeshes[0].indices[newMeshes[i].firstIndex] : NULL;
+	}
+
+	for(uint32_t i = 0; i < numMeshes; i++)
+	{
+		size_t nameSize = strlen(oldMeshes[i].material) + 1;
+		newMeshes[i].material = cur;
+		memcpy(cur, oldMeshes[i].material, nameSize);
+
+		cur += nameSize;
+	}
+
+	qobj_meshes_free(numMeshes, oldMeshes, allocator);
+	*meshes = newMeshes;
+
+	return QOBJ_SUCCESS;
+}
+
+//----------------------------------------------------------------------//
+//MATERIAL FUNCTIONS:
+
+QOBJmaterial qobj_default_material()
+{
+	QOBJmaterial result;
+	memset(&result, 0, sizeof(QOBJmaterial));
+
+	result.opacity = 1.0f;
+	result.specularExp = 1.0f;
+	result.refractionIndex = 1.0f;
+
+	return result;
+}
+
+void qobj_material_free(QOBJmaterial material, const QOBJallocator* allocator)
+{
+	qobj_free(allocator, material.name);
+
+	qobj_free(allocator, material.ambientMapPath);
+	qobj_free(allocator, material.diffuseMapPath);
+	qobj_free(allocator, material.specularMapPath);
+	qobj_free(allocator, material.normalMapPath);
+}
+
+//----------------------------------------------------------------------//
+//VERTEX HELPER FUNCTION:
+
+//parses a 1-based index starting at [str], negative (relative) indices are resolved against [count]
+//returns the number of bytes consumed, or 0 if there is no index or it is out of range
+QOBJ_INLINE uint32_t qobj_parse_index(const char* str, const char* end, uint32_t count, uint32_t* index)
+{
+	const char* start = str;
+
+	int32_t negative = 0;
+	if(str < end && *str == '-')
+	{
+		negative = 1;
+		str++;
+	}
+
+	const char* digitsStart = str;
+	uint64_t value = 0;
+	while(str < end && (uint32_t)(*str - '0') < 10)
+	{
+		value = value * 10 + (uint32_t)(*str - '0');
+		if(value > UINT32_MAX)
+			return 0;
+
+		str++;
+	}
+
+	if(str == digitsStart || value == 0 || value > count)
+		return 0;
+
+	*index = negative ? count + 1 - (uint32_t)value : (uint32_t)value;
+	return (uint32_t)(str - start);
+}
+
+//parses a vertex reference of the form "p", "p/t", "p//n" or "p/t/n" in a single pass
+//returns the number of bytes consumed (0 if there is no valid reference), [attribs] is set to the attributes given
+QOBJ_INLINE uint32_t qobj_parse_vertex_ref(const char* str, const char* end, QOBJvertexRef counts, QOBJvertexRef* vert, uint32_t* attribs)
+{
+	const char* start = str;
+
+	vert->normal = 0;
+	vert->texCoord = 0;
+	*attribs = QOBJ_VERTEX_ATTRIB_POSITION;
+
+	uint32_t len = qobj_parse_index(str, end, counts.pos, &vert->pos);
+	if(len == 0)
+		return 0;
+	str += len;
+
+	if(str < end && *str == '/')
+	{
+		str++;
+
+		if(str < end && *str != '/')
+		{
+			len = qobj_parse_index(str, end, counts.texCoord, &vert->texCoord);
+			if(len == 0)
+				return 0;
+			str += len;
+
+			*attribs |= QOBJ_VERTEX_ATTRIB_TEX_COORDS;
+		}
+
+		if(str < end && *str == '/')
+		{
+			str++;
+
+			len = qobj_parse_index(str, end, counts.normal, &vert->normal);
+			if(len == 0)
+				return 0;
+			str += len;
+
+			*attribs |= QOBJ_VERTEX_ATTRIB_NORMAL;
+		}
+	}
+
+	if(str < end && !qobj_is_space(*str))
+		return 0;
+
+	return (uint32_t)(str - start);
+}
+
+//returned by qobj_read_vertex_ref() for a malformed or out-of-range reference, never equal to a valid set of attributes
+#define QOBJ_VERTEX_REF_INVALID UINT32_MAX
+
+//reads the next vertex reference of a face, returns the attributes it specifies
+//returns 0 if the line has no more references (a trailing comment counts as the end), or QOBJ_VERTEX_REF_INVALID if the next one is bad
+QOBJ_INLINE uint32_t qobj_read_vertex_ref(const char** cur, const char* end, QOBJvertexRef counts, QOBJvertexRef* vert)
+{
+	qobj_skip_space(cur, end);
+	if(*cur >= end || **cur == '#')
+		return 0;
+
+	uint32_t attribs;
+	uint32_t len = qobj_parse_vertex_ref(*cur, end, counts, vert, &attribs);
+	if(len == 0)
+		return QOBJ_VERTEX_REF_INVALID;
+
+	*cur += len;
+	return attribs;
+}
+
+//copies the attributes [vert] refers to into a new vertex at the end of [mesh], which must have room for it
+//attributes of the mesh that [vert] does not refer to are set to 0
+QOBJ_INLINE void qobj_write_vertex(QOBJmesh* mesh, QOBJvertexRef vert, float* positions, float* texCoords, float* normals)
+{
 	uint32_t insertIdx = (uint32_t)mesh->numVertices++ * mesh->vertexStride;
 
-	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_POSITION && vert.pos > 0)
+	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_POSITION && vert.pos > 0)
+	{
+		uint32_t posIdx = (vert.pos - 1) * QOBJ_ATTRIB_SIZE_POSITION; //.obj files are 1-indexed
+
+		mesh->vertices[insertIdx + mesh->vertexPosOffset + 0] = positions[posIdx + 0];
+		mesh->vertices[insertIdx + mesh->vertexPosOffset + 1] = positions[posIdx + 1];
+		mesh->vertices[insertIdx + mesh->vertexPosOffset + 2] = positions[posIdx + 2];
+	}
+	else if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_POSITION)
+		memset(&mesh->vertices[insertIdx + mesh->vertexPosOffset], 0, QOBJ_ATTRIB_SIZE_POSITION * sizeof(float));
+
+	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_NORMAL && vert.normal > 0)
+	{
+		uint32_t normalIdx = (vert.normal - 1) * QOBJ_ATTRIB_SIZE_NORMAL; //.obj files are 1-indexed
+
+		mesh->vertices[insertIdx + mesh->vertexNormalOffset + 0] = normals[normalIdx + 0];
+		mesh->vertices[insertIdx + mesh->vertexNormalOffset + 1] = normals[normalIdx + 1];
+		mesh->vertices[insertIdx + mesh->vertexNormalOffset + 2] = normals[normalIdx + 2];
+	}
+	else if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_NORMAL)
+		memset(&mesh->vertices[insertIdx + mesh->vertexNormalOffset], 0, QOBJ_ATTRIB_SIZE_NORMAL * sizeof(float));
+
+	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_TEX_COORDS && vert.texCoord > 0)
+	{
+		uint32_t texCoordIdx = (vert.texCoord - 1) * QOBJ_ATTRIB_SIZE_TEX_COORDS; //.obj files are 1-indexed
+
+		mesh->vertices[insertIdx + mesh->vertexTexCoordOffset + 0] = texCoords[texCoordIdx + 0];
+		mesh->vertices[insertIdx + mesh->vertexTexCoordOffset + 1] = texCoords[texCoordIdx + 1];
+	}
+	else if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_TEX_COORDS)
+		memset(&mesh->vertices[insertIdx + mesh->vertexTexCoordOffset], 0, QOBJ_ATTRIB_SIZE_TEX_COORDS * sizeof(float));
+}
+
+//how many vertices ahead qobj_mesh_gather() prefetches the attributes of
+#define QOBJ_GATHER_PREFETCH_DISTANCE 16
+
+//prefetches the attributes [vert] refers to
+QOBJ_INLINE void qobj_prefetch_vertex(QOBJvertexRef vert, const float* positions, const float* texCoords, const float* normals)
+{
+	if(vert.pos > 0)
+		QOBJ_PREFETCH(&positions[(vert.pos - 1) * QOBJ_ATTRIB_SIZE_POSITION]);
+	if(vert.normal > 0)
+		QOBJ_PREFETCH(&normals[(vert.normal - 1) * QOBJ_ATTRIB_SIZE_NORMAL]);
+	if(vert.texCoord > 0)
+		QOBJ_PREFETCH(&texCoords[(vert.texCoord - 1) * QOBJ_ATTRIB_SIZE_TEX_COORDS]);
+}
+
+//writes the vertices of [mesh], one for each of its first mesh->numVertices [refs], once all of its indices are known
+//the attribute arrays are read in index order rather than file order, so they are prefetched a few vertices ahead
+QOBJerror qobj_mesh_gather(QOBJmesh* mesh, const QOBJvertexRef* refs, float* positions, float* texCoords, float* normals, const QOBJallocator* allocator)
+{
+	uint32_t numVertices = (uint32_t)mesh->numVertices;
+
+	QOBJerror errorCode = qobj_reserve_array((void**)&mesh->vertices, sizeof(float) * mesh->vertexStride, numVertices, &mesh->vertexCap, allocator);
+	if(errorCode != QOBJ_SUCCESS)
+		return errorCode;
+
+	mesh->numVertices = 0;
+
+	uint32_t i = 0;
+	for(; i + QOBJ_GATHER_PREFETCH_DISTANCE < numVertices; i++)
+	{
+		qobj_prefetch_vertex(refs[i + QOBJ_GATHER_PREFETCH_DISTANCE], positions, texCoords, normals);
+		qobj_write_vertex(mesh, refs[i], positions, texCoords, normals);
+	}
+
+	for(; i < numVertices; i++)
+		qobj_write_vertex(mesh, refs[i], positions, texCoords, normals);
+
+	return QOBJ_SUCCESS;
+}
+
+//adds an index for [vert] to [mesh], appending [vert] to [refs] if it is not in [map] yet
+//the mesh's vertices are written by qobj_mesh_gather() once all of them have been added
+QOBJ_INLINE QOBJerror qobj_add_vertex(QOBJmesh* mesh, QOBJvertexHashmap* map, QOBJvertexRef* refs, QOBJvertexRef vert)
+{
+	uint32_t indexToAdd = (uint32_t)mesh->numVertices;
+	QOBJerror mapError = qobj_hashmap_get_or_add(map, vert, &indexToAdd);
+	if(mapError != QOBJ_SUCCESS)
+		return mapError;
+
+	mesh->indices[mesh->numIndices++] = indexToAdd;
+	if(indexToAdd < (uint32_t)mesh->numVertices) //skip if vertex already exists in mesh
+		return QOBJ_SUCCESS;
+
+	refs[mesh->numVertices++] = vert;
+	return QOBJ_SUCCESS;
+}
+
+//----------------------------------------------------------------------//
+//MESH BUILDER FUNCTIONS:
+
+//prepares [builder] for a new mesh, which must be zeroed or hold the buffers of a mesh built with it earlier
+//those buffers are reused when they are large enough, so a builder kept in a QOBJcontext rarely allocates
+//[allocator] must be the one the builder was last reset with, if any
+QOBJerror qobj_builder_reset(QOBJmeshBuilder* builder, uint32_t flags, uint32_t vertexCap, uint32_t mapCap, int32_t packedKeys, uint32_t cornerCap,
+                             const QOBJallocator* allocator, const QOBJallocator* meshAllocator)
+{
+	if(flags & (QOBJ_LOAD_NO_DEDUP | QOBJ_LOAD_NO_INDICES))
+		flags &= ~(uint32_t)QOBJ_LOAD_SORT_DEDUP;
+
+	builder->flags = flags;
+	builder->allocator = allocator;
+	builder->meshAllocator = meshAllocator;
+	builder->numCorners = 0;
+	builder->numRuns = 0;
+
+	if(flags & QOBJ_LOAD_SORT_DEDUP)
+		return qobj_reserve_array((void**)&builder->corners, sizeof(QOBJvertexRef), cornerCap, &builder->cornerCap, allocator);
+
+	QOBJerror errorCode = qobj_reserve_array((void**)&builder->vertexRefs, sizeof(QOBJvertexRef), vertexCap, &builder->vertexRefCap, allocator);
+	if(errorCode != QOBJ_SUCCESS || (flags & (QOBJ_LOAD_NO_DEDUP | QOBJ_LOAD_NO_INDICES)))
+		return errorCode;
+
+	if(builder->map.ctrl && builder->map.packed == packedKeys && builder->map.cap >= mapCap)
+	{
+		qobj_hashmap_clear(&builder->map);
+		return QOBJ_SUCCESS;
+	}
+
+	qobj_hashmap_free(builder->map);
+	builder->map.ctrl = NULL;
+	builder->map.entries = NULL;
+	builder->map.packedEntries = NULL;
+
+	return qobj_hashmap_create(&builder->map, mapCap, packedKeys, allocator);
+}
+
+//a builder that was never reset holds no buffers, so it is never freed through its NULL allocator
+void qobj_builder_free(QOBJmeshBuilder builder)
+{
+	qobj_free(builder.allocator, builder.vertexRefs);
+	qobj_free(builder.allocator, builder.corners);
+	qobj_hashmap_free(builder.map);
+	qobj_free(builder.allocator, builder.runs);
+}
+
+//returns the number of indices the faces added so far will have once the mesh is finished
+QOBJ_INLINE uint32_t qobj_builder_num_indices(const QOBJmesh* mesh, const QOBJmeshBuilder* builder)
+{
+	return (builder->flags & QOBJ_LOAD_SORT_DEDUP) ? builder->numCorners : mesh->numIndices;
+}
+
+//records that all indices added since the last call, up to [end], belong to the mesh [meshIdx]
+QOBJ_INLINE QOBJerror qobj_builder_add_run(QOBJmeshBuilder* builder, uint32_t meshIdx, uint32_t end)
+{
+	if(builder->numRuns > 0 && builder->runs[builder->numRuns - 1].mesh == meshIdx)
+	{
+		builder->runs[builder->numRuns - 1].end = end;
+		return QOBJ_SUCCESS;
+	}
+
+	if(builder->numRuns == builder->runCap)
+	{
+		uint32_t newCap = builder->runCap > 0 ? builder->runCap * 2 : 16;
+		QOBJindexRun* newRuns = (QOBJindexRun*)qobj_realloc(builder->allocator, builder->runs, builder->runCap * sizeof(QOBJindexRun), newCap * sizeof(QOBJindexRun));
+		if(!newRuns)
+			return QOBJ_ERROR_OUT_OF_MEM;
+
+		builder->runs = newRuns;
+		builder->runCap = newCap;
+	}
+
+	builder->runs[builder->numRuns].mesh = meshIdx;
+	builder->runs[builder->numRuns].end = end;
+	builder->numRuns++;
+
+	return QOBJ_SUCCESS;
+}
+
+//adds the indices of a triangle to [mesh], its vertices are only referred to until the mesh is finished
+QOBJ_INLINE QOBJerror qobj_add_triangle(QOBJmesh* mesh, QOBJmeshBuilder* builder, QOBJvertexRef v0, QOBJvertexRef v1, QOBJvertexRef v2)
+{
+	//add every corner as a new vertex, if not deduplicating:
+	//---------------
+	if(builder->flags & (QOBJ_LOAD_NO_DEDUP | QOBJ_LOAD_NO_INDICES))
+	{
+		QOBJerror resizeError = qobj_maybe_resize_array((void**)&builder->vertexRefs, sizeof(QOBJvertexRef), mesh->numVertices + 3, &builder->vertexRefCap, builder->growthFactor, builder->allocator);
+		if(resizeError != QOBJ_SUCCESS)
+			return resizeError;
+
+		if(mesh->indices)
+		{
+			resizeError = qobj_maybe_resize_array((void**)&mesh->indices, sizeof(uint32_t), mesh->numIndices + 3, &mesh->indexCap, builder->growthFactor, builder->meshAllocator);
+			if(resizeError != QOBJ_SUCCESS)
+				return resizeError;
+
+			mesh->indices[mesh->numIndices++] = mesh->numVertices + 0;
+			mesh->indices[mesh->numIndices++] = mesh->numVertices + 1;
+			mesh->indices[mesh->numIndices++] = mesh->numVertices + 2;
+		}
+
+		builder->vertexRefs[mesh->numVertices++] = v0;
+		builder->vertexRefs[mesh->numVertices++] = v1;
+		builder->vertexRefs[mesh->numVertices++] = v2;
+
+		return QOBJ_SUCCESS;
+	}
+
+	//store corners to be deduplicated once all faces are read, if sorting:
+	//---------------
+	if(builder->flags & QOBJ_LOAD_SORT_DEDUP)
+	{
+		QOBJerror resizeError = qobj_maybe_resize_array((void**)&builder->corners, sizeof(QOBJvertexRef), builder->numCorners + 3, &builder->cornerCap, builder->growthFactor, builder->allocator);
+		if(resizeError != QOBJ_SUCCESS)
+			return resizeError;
+
+		builder->corners[builder->numCorners++] = v0;
+		builder->corners[builder->numCorners++] = v1;
+		builder->corners[builder->numCorners++] = v2;
+
+		return QOBJ_SUCCESS;
+	}
+
+	//resize buffers if needed:
+	//---------------
+	QOBJerror resizeError = qobj_maybe_resize_array((void**)&mesh->indices, sizeof(uint32_t), mesh->numIndices + 3, &mesh->indexCap, builder->growthFactor, builder->meshAllocator);
+	if(resizeError != QOBJ_SUCCESS)
+		return resizeError;
+
+	resizeError = qobj_maybe_resize_array((void**)&builder->vertexRefs, sizeof(QOBJvertexRef), mesh->numVertices + 3, &builder->vertexRefCap, builder->growthFactor, builder->allocator);
+	if(resizeError != QOBJ_SUCCESS)
+		return resizeError;
+
+	//add vertex refs + indices:
+	//---------------
+	QOBJerror addError = qobj_add_vertex(mesh, &builder->map, builder->vertexRefs, v0);
+	if(addError == QOBJ_SUCCESS)
+		addError = qobj_add_vertex(mesh, &builder->map, builder->vertexRefs, v1);
+	if(addError == QOBJ_SUCCESS)
+		addError = qobj_add_vertex(mesh, &builder->map, builder->vertexRefs, v2);
+
+	//return:
+	return addError;
+}
+
+//returns the number of bits needed to store every index from 0 to [count]
+QOBJ_INLINE uint32_t qobj_index_bits(uint32_t count)
+{
+	uint32_t numBits = 0;
+	while(numBits < 32 && (count >> numBits) != 0)
+		numBits++;
+
+	return numBits;
+}
+
+#define QOBJ_RADIX_BITS 11
+#define QOBJ_RADIX_SIZE (1 << QOBJ_RADIX_BITS)
+#define QOBJ_RADIX_MAX_PASSES ((64 + QOBJ_RADIX_BITS - 1) / QOBJ_RADIX_BITS)
+
+//sorts [count] keys and their values by the low [numBits] bits of the keys, keeping equal keys in their original order
+//the result is left in [*keys] and [*vals], which may be swapped with [*tmpKeys] and [*tmpVals]
+QOBJerror qobj_radix_sort(uint64_t** keys, uint32_t** vals, uint64_t** tmpKeys, uint32_t** tmpVals, uint32_t count, uint32_t numBits, const QOBJallocator* allocator)
+{
+	uint32_t numPasses = (numBits + QOBJ_RADIX_BITS - 1) / QOBJ_RADIX_BITS;
+
+	//count the digits of every pass at once:
+	//---------------
+	uint32_t* offsets = (uint32_t*)qobj_alloc(allocator, QOBJ_RADIX_MAX_PASSES * QOBJ_RADIX_SIZE * sizeof(uint32_t));
+	if(!offsets)
+		return QOBJ_ERROR_OUT_OF_MEM;
+
+	memset(offsets, 0, QOBJ_RADIX_MAX_PASSES * QOBJ_RADIX_SIZE * sizeof(uint32_t));
+
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint64_t key = (*keys)[i];
+		for(uint32_t pass = 0; pass < numPasses; pass++)
+			offsets[pass * QOBJ_RADIX_SIZE + ((key >> (pass * QOBJ_RADIX_BITS)) & (QOBJ_RADIX_SIZE - 1))]++;
+	}
+
+	for(uint32_t pass = 0; pass < numPasses; pass++)
+	{
+		uint32_t shift = pass * QOBJ_RADIX_BITS;
+		uint32_t* passOffsets = &offsets[pass * QOBJ_RADIX_SIZE];
+
+		uint64_t* srcKeys = *keys;
+		uint32_t* srcVals = *vals;
+
+		//skip the pass if every key has the same digit:
+		//---------------
+		if(passOffsets[(srcKeys[0] >> shift) & (QOBJ_RADIX_SIZE - 1)] == count)
+			continue;
+
+		uint32_t offset = 0;
+		for(uint32_t i = 0; i < QOBJ_RADIX_SIZE; i++)
+		{
+			uint32_t digitCount = passOffsets[i];
+			passOffsets[i] = offset;
+			offset += digitCount;
+		}
+
+		//scatter into the other buffers and swap:
+		//---------------
+		uint64_t* dstKeys = *tmpKeys;
+		uint32_t* dstVals = *tmpVals;
+		for(uint32_t i = 0; i < count; i++)
+		{
+			uint32_t dst = passOffsets[(srcKeys[i] >> shift) & (QOBJ_RADIX_SIZE - 1)]++;
+			dstKeys[dst] = srcKeys[i];
+			dstVals[dst] = srcVals[i];
+		}
+
+		*tmpKeys = srcKeys;
+		*tmpVals = srcVals;
+		*keys = dstKeys;
+		*vals = dstVals;
+	}
+
+	qobj_free(allocator, offsets);
+	return QOBJ_SUCCESS;
+}
+
+//deduplicates the stored corners with a hashmap, used when their indices are too large to pack into a sort key
+//the unique corners are moved to the front of the corners in order of first use, a vertex is never after its first use
+QOBJerror qobj_builder_hash_corners(QOBJmesh* mesh, QOBJmeshBuilder* builder)
+{
+	QOBJvertexHashmap map;
+	QOBJerror errorCode = qobj_hashmap_create(&map, 32, 0, builder->allocator);
+	if(errorCode != QOBJ_SUCCESS)
+		return errorCode;
+
+	for(uint32_t i = 0; i < builder->numCorners && errorCode == QOBJ_SUCCESS; i++)
+		errorCode = qobj_add_vertex(mesh, &map, builder->corners, builder->corners[i]);
+
+	qobj_hashmap_free(map);
+	return errorCode;
+}
+
+//deduplicates the stored corners by radix sorting them, giving exactly the vertices and indices a hashmap would
+//each corner's (pos, texCoord, normal) is packed into a 64-bit key, and the sort keeps equal keys in face order, so the first
+//corner of each run of equal keys is its vertex's first use. the unique corners are then moved to the front of the corners in order of first use
+QOBJerror qobj_builder_sort_corners(QOBJmesh* mesh, QOBJmeshBuilder* builder, QOBJvertexRef counts)
+{
+	uint32_t numCorners = builder->numCorners;
+
+	//ensure index buffer can hold every corner:
+	//---------------
+	if(mesh->indexCap < numCorners + 1)
+	{
+		uint32_t* newIndices = (uint32_t*)qobj_realloc(builder->meshAllocator, mesh->indices, mesh->indexCap * sizeof(uint32_t), (numCorners + 1) * sizeof(uint32_t));
+		if(!newIndices)
+			return QOBJ_ERROR_OUT_OF_MEM;
+
+		mesh->indices = newIndices;
+		mesh->indexCap = numCorners + 1;
+	}
+
+	//fall back to a hashmap if the indices are too large to pack:
+	//---------------
+	uint32_t normalBits = qobj_index_bits(counts.normal);
+	uint32_t texCoordBits = qobj_index_bits(counts.texCoord);
+	uint32_t numBits = qobj_index_bits(counts.pos) + texCoordBits + normalBits;
+	if(numBits > 64)
+		return qobj_builder_hash_corners(mesh, builder);
+
+	//allocate memory:
+	//---------------
+	uint64_t* keys    = (uint64_t*)qobj_alloc(builder->allocator, numCorners * sizeof(uint64_t));
+	uint64_t* tmpKeys = (uint64_t*)qobj_alloc(builder->allocator, numCorners * sizeof(uint64_t));
+	uint32_t* vals    = (uint32_t*)qobj_alloc(builder->allocator, numCorners * sizeof(uint32_t));
+	uint32_t* tmpVals = (uint32_t*)qobj_alloc(builder->allocator, numCorners * sizeof(uint32_t));
+
+	if(!keys || !tmpKeys || !vals || !tmpVals)
+	{
+		qobj_free(builder->allocator, keys);
+		qobj_free(builder->allocator, tmpKeys);
+		qobj_free(builder->allocator, vals);
+		qobj_free(builder->allocator, tmpVals);
+		return QOBJ_ERROR_OUT_OF_MEM;
+	}
+
+	//pack and sort keys:
+	//---------------
+	for(uint32_t i = 0; i < numCorners; i++)
+	{
+		QOBJvertexRef corner = builder->corners[i];
+		keys[i] = ((uint64_t)corner.pos << (texCoordBits + normalBits)) | ((uint64_t)corner.texCoord << normalBits) | corner.normal;
+		vals[i] = i;
+	}
+
+	QOBJerror errorCode = qobj_radix_sort(&keys, &vals, &tmpKeys, &tmpVals, numCorners, numBits, builder->allocator);
+	if(errorCode != QOBJ_SUCCESS)
+	{
+		qobj_free(builder->allocator, keys);
+		qobj_free(builder->allocator, tmpKeys);
+		qobj_free(builder->allocator, vals);
+		qobj_free(builder->allocator, tmpVals);
+		return errorCode;
+	}
+
+	//point every corner at the first corner with the same key:
+	//---------------
+	uint32_t* firstUse = tmpVals;
+
+	for(uint32_t i = 0; i < numCorners;)
+	{
+		uint32_t first = vals[i];
+
+		uint64_t key = keys[i];
+		for(; i < numCorners && keys[i] == key; i++)
+			firstUse[vals[i]] = first;
+	}
+
+	qobj_free(builder->allocator, keys);
+	qobj_free(builder->allocator, tmpKeys);
+	qobj_free(builder->allocator, vals);
+
+	//number vertices in order of first use, first uses are overwritten with their vertex index as they are reached:
+	//---------------
+	for(uint32_t i = 0; i < numCorners; i++)
+	{
+		uint32_t first = firstUse[i];
+		if(first == i)
+		{
+			firstUse[i] = mesh->numVertices;
+			builder->corners[mesh->numVertices++] = builder->corners[i]; //never past i, so no unread corner is overwritten
+		}
+
+		mesh->indices[i] = firstUse[first];
+	}
+
+	mesh->numIndices = numCorners;
+
+	qobj_free(builder->allocator, firstUse);
+	return QOBJ_SUCCESS;
+}
+
+//splits the indices of every face, all built in the first mesh, into a contiguous range per mesh using the runs of [builder]
+//then points every mesh at the first mesh's vertices and its range of the indices
+QOBJerror qobj_builder_split_shared(uint32_t numMeshes, QOBJmesh* meshes, const QOBJmeshBuilder* builder)
+{
+	QOBJmesh* shared = &meshes[0];
+	uint32_t numIndices = shared->numIndices;
+
+	uint32_t* offsets = (uint32_t*)qobj_alloc(builder->allocator, numMeshes * sizeof(uint32_t));
+	uint32_t* indices = (uint32_t*)qobj_alloc(builder->meshAllocator, (numIndices + 1) * sizeof(uint32_t));
+	if(!offsets || !indices)
+	{
+		qobj_free(builder->allocator, offsets);
+		qobj_free(builder->meshAllocator, indices);
+		return QOBJ_ERROR_OUT_OF_MEM;
+	}
+
+	//count indices per mesh and give each a range:
+	//---------------
+	shared->numIndices = 0;
+
+	uint32_t start = 0;
+	for(uint32_t i = 0; i < builder->numRuns; i++)
+	{
+		meshes[builder->runs[i].mesh].numIndices += builder->runs[i].end - start;
+		start = builder->runs[i].end;
+	}
+
+	uint32_t firstIndex = 0;
+	for(uint32_t i = 0; i < numMeshes; i++)
+	{
+		offsets[i] = firstIndex;
+		meshes[i].firstIndex = firstIndex;
+		firstIndex += meshes[i].numIndices;
+	}
+
+	//copy runs into their ranges:
+	//---------------
+	start = 0;
+	for(uint32_t i = 0; i < builder->numRuns; i++)
+	{
+		uint32_t runSize = builder->runs[i].end - start;
+		memcpy(&indices[offsets[builder->runs[i].mesh]], &shared->indices[start], runSize * sizeof(uint32_t));
+
+		offsets[builder->runs[i].mesh] += runSize;
+		start = builder->runs[i].end;
+	}
+
+	qobj_free(builder->allocator, offsets);
+	qobj_free(builder->meshAllocator, shared->indices);
+
+	//point meshes at the shared buffers:
+	//---------------
+	for(uint32_t i = 0; i < numMeshes; i++)
+	{
+		QOBJmesh* mesh = &meshes[i];
+
+		mesh->vertexAttribs = shared->vertexAttribs;
+		mesh->vertexStride = shared->vertexStride;
+		mesh->vertexPosOffset = shared->vertexPosOffset;
+		mesh->vertexNormalOffset = shared->vertexNormalOffset;
+		mesh->vertexTexCoordOffset = shared->vertexTexCoordOffset;
+
+		mesh->numVertices = shared->numVertices;
+		mesh->vertexCap = shared->vertexCap;
+		mesh->vertices = shared->vertices;
+
+		mesh->indexCap = mesh->numIndices;
+		mesh->indices = &indices[mesh->firstIndex];
+	}
+
+	shared->indexCap = numIndices + 1; //the first mesh owns the whole buffer
+
+	return QOBJ_SUCCESS;
+}
+
+//finishes building a mesh once all of its faces have been added, deduplicating its corners if sorting and then writing its vertices
+QOBJerror qobj_builder_finish(QOBJmesh* mesh, QOBJmeshBuilder* builder, QOBJvertexRef counts, float* positions, float* texCoords, float* normals)
+{
+	if(!(builder->flags & QOBJ_LOAD_SORT_DEDUP))
+		return qobj_mesh_gather(mesh, builder->vertexRefs, positions, texCoords, normals, builder->meshAllocator);
+
+	if(builder->numCorners == 0)
+		return QOBJ_SUCCESS;
+
+	QOBJerror errorCode = qobj_builder_sort_corners(mesh, builder, counts);
+	if(errorCode != QOBJ_SUCCESS)
+		return errorCode;
+
+	return qobj_mesh_gather(mesh, builder->corners, positions, texCoords, normals, builder->meshAllocator);
+}
+
+//----------------------------------------------------------------------//
+//CONTEXT FUNCTIONS:
+
+//zeroes [context], so it holds no memory yet
+void qobj_context_init(QOBJcontext* context, const QOBJallocator* allocator)
+{
+	memset(context, 0, sizeof(QOBJcontext));
+	context->allocator = *qobj_get_allocator(allocator);
+}
+
+QOBJerror qobj_context_create(const QOBJallocator* allocator, QOBJcontext** context)
+{
+	*context = (QOBJcontext*)qobj_alloc(qobj_get_allocator(allocator), sizeof(QOBJcontext));
+	if(!*context)
+		return QOBJ_ERROR_OUT_OF_MEM;
+
+	qobj_context_init(*context, allocator);
+	return QOBJ_SUCCESS;
+}
+
+//frees the memory kept by [context], but not [context] itself
+void qobj_context_release(QOBJcontext* context)
+{
+	qobj_free(&context->allocator, context->positions);
+	qobj_free(&context->allocator, context->normals);
+	qobj_free(&context->allocator, context->texCoords);
+
+	for(uint32_t i = 0; i < context->builderCap; i++)
+		qobj_builder_free(context->builders[i]);
+
+	qobj_free(&context->allocator, context->builders);
+}
+
+void qobj_context_free(QOBJcontext* context)
+{
+	if(!context)
+		return;
+
+	qobj_context_release(context);
+
+	QOBJallocator allocator = context->allocator; //the context is freed with its own allocator
+	qobj_free(&allocator, context);
+}
+
+//returns the context a load with [options] uses, [localContext] is set up and used if the caller does not keep one
+QOBJcontext* qobj_context_for_load(const QOBJloadOptions* options, QOBJcontext* localContext)
+{
+	if(options->context)
+		return options->context;
+
+	qobj_context_init(localContext, options->allocator);
+	return localContext;
+}
+
+//makes sure the attribute arrays of [context] have room for at least the given number of each attribute
+QOBJerror qobj_context_reserve(QOBJcontext* context, uint32_t positionCap, uint32_t normalCap, uint32_t texCoordCap)
+{
+	QOBJerror errorCode = qobj_reserve_array((void**)&context->positions, sizeof(float) * QOBJ_ATTRIB_SIZE_POSITION, positionCap, &context->positionCap, &context->allocator);
+	if(errorCode == QOBJ_SUCCESS)
+		errorCode = qobj_reserve_array((void**)&context->normals, sizeof(float) * QOBJ_ATTRIB_SIZE_NORMAL, normalCap, &context->normalCap, &context->allocator);
+	if(errorCode == QOBJ_SUCCESS)
+		errorCode = qobj_reserve_array((void**)&context->texCoords, sizeof(float) * QOBJ_ATTRIB_SIZE_TEX_COORDS, texCoordCap, &context->texCoordCap, &context->allocator);
+
+	return errorCode;
+}
+
+//----------------------------------------------------------------------//
+//WELD FUNCTIONS:
+
+#ifndef QOBJ_WELD_CELL_SCALE
+	#define QOBJ_WELD_CELL_SCALE 4 //the width of a weld grid cell, in position epsilons
+#endif
+
+//the largest grid cell a coordinate is given, coordinates past it (or NaN) are given the cell of their bits instead.
+//floats that far out are more than 2^40 epsilons apart, so only exactly equal ones can be welded there anyway
+#define QOBJ_WELD_MAX_CELL 4611686018427387904.0 //2^62
+
+//returns whether [x] can be given a grid cell, at the [invCellSize] of the mesh being welded
+QOBJ_INLINE int32_t qobj_weld_in_grid(float x, double invCellSize)
+{
+	double d = (double)x * invCellSize;
+	return d > -QOBJ_WELD_MAX_CELL && d < QOBJ_WELD_MAX_CELL; //also false for NaN
+}
+
+//returns the grid cell [x] falls in, [x] must be within a few cells of the grid's range
+QOBJ_INLINE int64_t qobj_weld_cell(double x, double invCellSize)
+{
+	double d = x * invCellSize;
+	int64_t cell = (int64_t)d;
+	return (double)cell > d ? cell - 1 : cell;
+}
+
+//returns the bits of [x], used as its cell when only exactly equal positions are welded
+QOBJ_INLINE int64_t qobj_weld_bits(float x)
+{
+	uint32_t bits;
+	x += 0.0f; //-0 and 0 share a cell
+	memcpy(&bits, &x, sizeof(uint32_t));
+	return (int64_t)bits;
+}
+
+//hashes all 64 bits of each cell coordinate, so cells far from the origin spread as well as those near it
+QOBJ_INLINE uint32_t qobj_weld_hash(int64_t x, int64_t y, int64_t z)
+{
+	return qobj_hashmap_mix(((uint64_t)x * 73856093u) ^ ((uint64_t)y * 19349663u) ^ ((uint64_t)z * 83492791u));
+}
+
+QOBJ_INLINE int32_t qobj_weld_near(const float* a, const float* b, uint32_t count, float epsilon)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		float diff = a[i] - b[i];
+		if(diff > epsilon || diff < -epsilon || diff != diff)
+			return 0;
+	}
+
+	return 1;
+}
+
+//merges vertices whose attributes are all within the epsilons of [options], keeps the first vertex of each group
+//[allocator] is only used for the grid, the mesh's buffers are shrunk in place
+QOBJerror qobj_mesh_weld(QOBJmesh* mesh, const QOBJloadOptions* options, const QOBJallocator* allocator)
+{
+	if(!mesh->indices || mesh->numVertices < 2 || !(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_POSITION))
+		return QOBJ_SUCCESS;
+
+	//allocate grid:
+	//---------------
+	uint64_t tableSize = 16;
+	while(tableSize < (uint64_t)mesh->numVertices * 2)
+		tableSize *= 2;
+	uint32_t tableMask = (uint32_t)(tableSize - 1);
+
+	uint32_t* heads = (uint32_t*)qobj_alloc(allocator, tableSize * sizeof(uint32_t));
+	uint32_t* next = (uint32_t*)qobj_alloc(allocator, mesh->numVertices * sizeof(uint32_t));
+	uint32_t* remap = (uint32_t*)qobj_alloc(allocator, mesh->numVertices * sizeof(uint32_t));
+	if(!heads || !next || !remap)
+	{
+		qobj_free(allocator, heads);
+		qobj_free(allocator, next);
+		qobj_free(allocator, remap);
+		return QOBJ_ERROR_OUT_OF_MEM;
+	}
+
+	memset(heads, 0xFF, tableSize * sizeof(uint32_t));
+
+	//cells are wider than the epsilon so most vertices only search their own cell, the search is widened
+	//to the neighboring cells a vertex is close to the edge of; the reach is padded for float rounding
+	float posEpsilon = options->weldPosEpsilon > 0.0f ? options->weldPosEpsilon : 0.0f;
+	double invCellSize = posEpsilon > 0.0f ? 1.0 / (QOBJ_WELD_CELL_SCALE * (double)posEpsilon) : 0.0;
+	double reach = (double)posEpsilon * 1.0001;
+
+	//weld vertices, compacting the survivors in place:
+	//---------------
+	uint32_t stride = mesh->vertexStride;
+	uint32_t numWelded = 0;
+	for(uint32_t i = 0; i < mesh->numVertices; i++)
+	{
+		const float* vert = &mesh->vertices[i * stride];
+		const float* pos = &vert[mesh->vertexPosOffset];
+
+		int64_t cell[3], minCell[3], maxCell[3];
+		for(uint32_t k = 0; k < 3; k++)
+		{
+			if(posEpsilon > 0.0f && qobj_weld_in_grid(pos[k], invCellSize))
+			{
+				cell[k] = qobj_weld_cell(pos[k], invCellSize);
+				minCell[k] = qobj_weld_cell(pos[k] - reach, invCellSize);
+				maxCell[k] = qobj_weld_cell(pos[k] + reach, invCellSize);
+			}
+			else
+				cell[k] = minCell[k] = maxCell[k] = qobj_weld_bits(pos[k]);
+		}
+
+		uint32_t match = UINT32_MAX;
+		for(int64_t z = minCell[2]; z <= maxCell[2] && match == UINT32_MAX; z++)
+		for(int64_t y = minCell[1]; y <= maxCell[1] && match == UINT32_MAX; y++)
+		for(int64_t x = minCell[0]; x <= maxCell[0] && match == UINT32_MAX; x++)
+		{
+			uint32_t bucket = qobj_weld_hash(x, y, z) & tableMask;
+			for(uint32_t j = heads[bucket]; j != UINT32_MAX; j = next[j])
+			{
+				const float* other = &mesh->vertices[j * stride];
+
+				if(!qobj_weld_near(pos, &other[mesh->vertexPosOffset], QOBJ_ATTRIB_SIZE_POSITION, posEpsilon))
+					continue;
+				if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_NORMAL &&
+				   !qobj_weld_near(&vert[mesh->vertexNormalOffset], &other[mesh->vertexNormalOffset], QOBJ_ATTRIB_SIZE_NORMAL, options->weldNormalEpsilon))
+					continue;
+				if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_TEX_COORDS &&
+				   !qobj_weld_near(&vert[mesh->vertexTexCoordOffset], &other[mesh->vertexTexCoordOffset], QOBJ_ATTRIB_SIZE_TEX_COORDS, options->weldTexCoordEpsilon))
+					continue;
+
+				match = j;
+				break;
+			}
+		}
+
+		if(match != UINT32_MAX)
+		{
+			remap[i] = match;
+			continue;
+		}
+
+		if(numWelded != i)
+			memcpy(&mesh->vertices[numWelded * stride], vert, stride * sizeof(float));
+
+		uint32_t bucket = qobj_weld_hash(cell[0], cell[1], cell[2]) & tableMask;
+		next[numWelded] = heads[bucket];
+		heads[bucket] = numWelded;
+
+		remap[i] = numWelded++;
+	}
+
+	//remap indices:
+	//---------------
+	for(uint32_t i = 0; i < mesh->numIndices; i++)
+		mesh->indices[i] = remap[mesh->indices[i]];
+
+	mesh->numVertices = numWelded;
+
+	qobj_free(allocator, heads);
+	qobj_free(allocator, next);
+	qobj_free(allocator, remap);
+
+	return QOBJ_SUCCESS;
+}
+
+//----------------------------------------------------------------------//
+//PREFLIGHT FUNCTIONS:
+
+QOBJpreflightMaterial* qobj_preflight_find(const QOBJpreflight* preflight, const char* name)
+{
+	for(uint32_t i = 0; i < preflight->numMaterials; i++)
+		if(strcmp(preflight->materials[i].name, name) == 0)
+			return &preflight->materials[i];
+
+	return NULL;
+}
+
+QOBJerror qobj_preflight_count(QOBJstream* stream, QOBJpreflight* preflight, const QOBJallocator* allocator)
+{
+	preflight->numPositions = 0;
+	preflight->numNormals = 0;
+	preflight->numTexCoords = 0;
+	preflight->numMaterials = 0;
+	preflight->materials = NULL;
+
+	char curMaterial[QOBJ_MAX_TOKEN_LEN] = {0};
+	QOBJpreflightMaterial* material = NULL; //resolved lazily, materials without faces are never added
+
+	const char* lineStart;
+	const char* lineEnd;
+	while(qobj_next_line(stream, &lineStart, &lineEnd))
+	{
+		const char* cur = lineStart;
+
+		QOBJobjKeyword keyword = qobj_read_obj_keyword(&cur, lineEnd);
+
+		if(keyword == QOBJ_OBJ_KEYWORD_V)
+			preflight->numPositions++;
+		else if(keyword == QOBJ_OBJ_KEYWORD_F)
+		{
+			//count corners without parsing them:
+			//---------------
+			uint32_t numCorners = 0;
+			while(1)
+			{
+				qobj_skip_space(&cur, lineEnd);
+				if(cur >= lineEnd)
+					break;
+
+				numCorners++;
+				while(cur < lineEnd && !qobj_is_space(*cur))
+					cur++;
+			}
+
+			if(numCorners < 3)
+				continue;
+
+			//add counts to material:
+			//---------------
+			if(!material)
+			{
+				material = qobj_preflight_find(preflight, curMaterial);
+				if(!material)
+				{
+					QOBJpreflightMaterial* newMaterials = (QOBJpreflightMaterial*)qobj_realloc(allocator, preflight->materials,
+						preflight->numMaterials * sizeof(QOBJpreflightMaterial), (preflight->numMaterials + 1) * sizeof(QOBJpreflightMaterial));
+					if(!newMaterials)
+						return QOBJ_ERROR_OUT_OF_MEM;
+
+					preflight->materials = newMaterials;
+					material = &preflight->materials[preflight->numMaterials++];
+
+					memcpy(material->name, curMaterial, QOBJ_MAX_TOKEN_LEN);
+					material->numIndices = 0;
+					material->numCorners = 0;
+				}
+			}
+
+			material->numIndices += (numCorners - 2) * 3;
+			material->numCorners += numCorners;
+		}
+		else if(keyword == QOBJ_OBJ_KEYWORD_VN)
+			preflight->numNormals++;
+		else if(keyword == QOBJ_OBJ_KEYWORD_VT)
+			preflight->numTexCoords++;
+		else if(keyword == QOBJ_OBJ_KEYWORD_USEMTL)
+		{
+			qobj_rest_of_line(&cur, lineEnd, curMaterial);
+			material = NULL;
+		}
+	}
+
+	return QOBJ_SUCCESS;
+}
+
+//returns the capacity a vertex hashmap needs to hold [numVertices] without growing
+uint32_t qobj_hashmap_cap_for(uint32_t numVertices)
+{
+	uint64_t cap = 32;
+	while(QOBJ_HASHMAP_MAX_SIZE(cap) < numVertices && cap < ((uint64_t)1 << 31))
+		cap *= 2;
+
+	return (uint32_t)cap;
+}
+
+//gets initial buffer capacities for a new mesh, sized from a preflight pass if one was made, or the hints in [options] otherwise
+//a NULL [materialName] gets capacities for a mesh holding the faces of every material
+void qobj_preflight_mesh_caps(const QOBJpreflight* preflight, const char* materialName, const QOBJloadOptions* options,
+                              uint32_t* vertexCap, uint32_t* indexCap, uint32_t* mapCap)
+{
+	*vertexCap = options->vertexCap;
+	*indexCap = options->indexCap > 0 ? options->indexCap : 1; //a mesh with indices must start with an index buffer
+	*mapCap = qobj_hashmap_cap_for(options->mapCap);
+
+	//a NULL name gets caps for the faces of every material:
+	//---------------
+	QOBJpreflightMaterial* material;
+	QOBJpreflightMaterial allMaterials = {{0}, 0, 0};
+	if(materialName)
+		material = qobj_preflight_find(preflight, materialName);
+	else
 	{
-		uint32_t posIdx = (vert.pos - 1) * QOBJ_ATTRIB_SIZE_POSITION; //.obj files are 1-indexed
+		for(uint32_t i = 0; i < preflight->numMaterials; i++)
+		{
+			allMaterials.numIndices += preflight->materials[i].numIndices;
+			allMaterials.numCorners += preflight->materials[i].numCorners;
+		}
 
-		mesh->vertices[insertIdx + mesh->vertexPosOffset + 0] = positions[posIdx + 0];
-		mesh->vertices[insertIdx + mesh->vertexPosOffset + 1] = positions[posIdx + 1];
-		mesh->vertices[insertIdx + mesh->vertexPosOffset + 2] = positions[posIdx + 2];
+		material = preflight->numMaterials > 0 ? &allMaterials : NULL;
 	}
 
-	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_NORMAL && vert.normal > 0)
+	if(!material)
+		return;
+
+	//the number of unique vertices is not known until they are deduplicated, so estimate it from the
+	//attribute counts; the vertex buffer still grows if the estimate is too small
+	uint32_t maxAttribs = preflight->numPositions;
+	if(preflight->numNormals > maxAttribs)
+		maxAttribs = preflight->numNormals;
+	if(preflight->numTexCoords > maxAttribs)
+		maxAttribs = preflight->numTexCoords;
+
+	uint32_t numVertices = material->numCorners < maxAttribs ? material->numCorners : maxAttribs;
+
+	*vertexCap = numVertices + 3; //qobj_add_triangle() needs room for 3 more vertices
+	*indexCap = material->numIndices + 1;
+	*mapCap = qobj_hashmap_cap_for(numVertices);
+}
+
+void qobj_preflight_free(QOBJpreflight preflight, const QOBJallocator* allocator)
+{
+	qobj_free(allocator, preflight.materials);
+}
+
+//----------------------------------------------------------------------//
+//PARALLEL FUNCTIONS:
+
+#ifndef QOBJ_MIN_CHUNK_SIZE
+	#define QOBJ_MIN_CHUNK_SIZE (1 << 20)
+#endif
+
+//returns the number of chunks to split [len] bytes into, 1 if they should be parsed serially
+uint32_t qobj_num_chunks(const QOBJloadOptions* options, size_t len)
+{
+#ifdef QOBJ_THREADS
+	size_t numChunks = options->numThreads;
+	if(numChunks == 0)
 	{
-		uint32_t normalIdx = (vert.normal - 1) * QOBJ_ATTRIB_SIZE_NORMAL; //.obj files are 1-indexed
+		long numCores = sysconf(_SC_NPROCESSORS_ONLN);
+		numChunks = numCores > 0 ? (size_t)numCores : 1;
+	}
 
-		mesh->vertices[insertIdx + mesh->vertexNormalOffset + 0] = normals[normalIdx + 0];
-		mesh->vertices[insertIdx + mesh->vertexNormalOffset + 1] = normals[normalIdx + 1];
-		mesh->vertices[insertIdx + mesh->vertexNormalOffset + 2] = normals[normalIdx + 2];
+	//small files are not worth the cost of starting threads
+	if(numChunks > len / QOBJ_MIN_CHUNK_SIZE)
+		numChunks = len / QOBJ_MIN_CHUNK_SIZE;
+
+	return numChunks > 1 ? (uint32_t)numChunks : 1;
+#else
+	(void)options;
+	(void)len;
+	return 1;
+#endif
+}
+
+//splits [start, end) into [numChunks] ranges of roughly equal size, each ending at a line boundary
+void qobj_chunks_split(const char* start, const char* end, uint32_t numChunks, QOBJchunk* chunks)
+{
+	size_t len = end - start;
+
+	const char* chunkStart = start;
+	for(uint32_t i = 0; i < numChunks; i++)
+	{
+		const char* chunkEnd = end;
+		if(i < numChunks - 1)
+		{
+			const char* target = start + len / numChunks * (i + 1);
+			if(target < chunkStart)
+				target = chunkStart;
+
+			const char* newline = qobj_find_newline(target, end);
+			if(newline)
+				chunkEnd = newline + 1;
+		}
+
+		memset(&chunks[i], 0, sizeof(QOBJchunk));
+		chunks[i].start = chunkStart;
+		chunks[i].end = chunkEnd;
+
+		chunkStart = chunkEnd;
 	}
+}
 
-	if(mesh->vertexAttribs & QOBJ_VERTEX_ATTRIB_TEX_COORDS && vert.texCoord > 0)
+//counts the attributes defined in a chunk
+void* qobj_chunk_count(void* arg)
+{
+	QOBJchunk* chunk = (QOBJchunk*)arg;
+
+	QOBJstream stream;
+	qobj_stream_from_memory(&stream, chunk->start, chunk->end - chunk->start);
+
+	const char* lineStart;
+	const char* lineEnd;
+	while(qobj_next_line(&stream, &lineStart, &lineEnd))
 	{
-		uint32_t texCoordIdx = (vert.texCoord - 1) * QOBJ_ATTRIB_SIZE_TEX_COORDS; //.obj files are 1-indexed
+		const char* cur = lineStart;
 
-		mesh->vertices[insertIdx + mesh->vertexTexCoordOffset + 0] = texCoords[texCoordIdx + 0];
-		mesh->vertices[insertIdx + mesh->vertexTexCoordOffset + 1] = texCoords[texCoordIdx + 1];
+		QOBJobjKeyword keyword = qobj_read_obj_keyword(&cur, lineEnd);
+
+		if(keyword == QOBJ_OBJ_KEYWORD_V)
+			chunk->counts.pos++;
+		else if(keyword == QOBJ_OBJ_KEYWORD_VN)
+			chunk->counts.normal++;
+		else if(keyword == QOBJ_OBJ_KEYWORD_VT)
+			chunk->counts.texCoord++;
 	}
+
+	return NULL;
 }
 
-inline QOBJerror qobj_add_triangle(QOBJmesh* mesh, QOBJvertexHashmap* map, QOBJvertexRef v0, QOBJvertexRef v1, QOBJvertexRef v2,
-                                   float* positions, float* texCoords, float* normals)
+//parses a chunk's attributes into the shared arrays, and its faces into the chunk's own lists
+//indices are validated and resolved against the attributes of all previous chunks, exactly as in a serial load
+void* qobj_chunk_parse(void* arg)
 {
-	//resize buffers if needed:
+	QOBJchunk* chunk = (QOBJchunk*)arg;
+
+	//allocate memory:
 	//---------------
-	QOBJerror resizeError = qobj_maybe_resize_array((void**)&mesh->indices, sizeof(uint32_t), mesh->numIndices + 3, &mesh->indexCap);
-	if(resizeError != QOBJ_SUCCESS)
-		return resizeError;
+	chunk->faceCap = 32;
+	chunk->cornerCap = 32;
+	chunk->materialCap = 4;
 
-	resizeError = qobj_maybe_resize_array((void**)&mesh->vertices, sizeof(float) * mesh->vertexStride, mesh->numVertices + 3, &mesh->vertexCap);
-	if(resizeError != QOBJ_SUCCESS)
-		return resizeError;
+	chunk->faces = (QOBJchunkFace*)qobj_alloc(chunk->allocator, chunk->faceCap * sizeof(QOBJchunkFace));
+	chunk->corners = (QOBJvertexRef*)qobj_alloc(chunk->allocator, chunk->cornerCap * sizeof(QOBJvertexRef));
+	chunk->materials = (char*)qobj_alloc(chunk->allocator, chunk->materialCap * QOBJ_MAX_TOKEN_LEN);
+
+	if(!chunk->faces || !chunk->corners || !chunk->materials)
+	{
+		chunk->error = QOBJ_ERROR_OUT_OF_MEM;
+		return NULL;
+	}
+
+	//main loop:
+	//---------------
+	QOBJstream stream;
+	qobj_stream_from_memory(&stream, chunk->start, chunk->end - chunk->start);
+
+	const char* lineStart;
+	const char* lineEnd;
+
+	QOBJvertexRef counts = chunk->offsets;
+	uint32_t curMaterial = UINT32_MAX; //material set before this chunk
+
+	while(qobj_next_line(&stream, &lineStart, &lineEnd))
+	{
+		const char* cur = lineStart;
+
+		QOBJobjKeyword keyword = qobj_read_obj_keyword(&cur, lineEnd);
+
+		if(keyword == QOBJ_OBJ_KEYWORD_V)
+			qobj_read_floats(&cur, lineEnd, &chunk->positions[counts.pos++ * QOBJ_ATTRIB_SIZE_POSITION], QOBJ_ATTRIB_SIZE_POSITION);
+		else if(keyword == QOBJ_OBJ_KEYWORD_VN)
+			qobj_read_floats(&cur, lineEnd, &chunk->normals[counts.normal++ * QOBJ_ATTRIB_SIZE_NORMAL], QOBJ_ATTRIB_SIZE_NORMAL);
+		else if(keyword == QOBJ_OBJ_KEYWORD_VT)
+			qobj_read_floats(&cur, lineEnd, &chunk->texCoords[counts.texCoord++ * QOBJ_ATTRIB_SIZE_TEX_COORDS], QOBJ_ATTRIB_SIZE_TEX_COORDS);
+		else if(keyword == QOBJ_OBJ_KEYWORD_F)
+		{
+			QOBJchunkFace face;
+			face.material = curMaterial;
+			face.firstCorner = chunk->numCorners;
+
+			//read corners, all must have the same format as the first:
+			//---------------
+			QOBJvertexRef vert;
+			face.spec = qobj_read_vertex_ref(&cur, lineEnd, counts, &vert);
+			if(face.spec == QOBJ_VERTEX_REF_INVALID)
+			{
+				chunk->error = QOBJ_ERROR_INVALID_FILE;
+				return NULL;
+			}
+
+			uint32_t attribs = face.spec;
+			while(attribs != 0)
+			{
+				if(attribs != face.spec)
+				{
+					chunk->error = QOBJ_ERROR_INVALID_FILE;
+					return NULL;
+				}
+
+				chunk->error = qobj_maybe_resize_array((void**)&chunk->corners, sizeof(QOBJvertexRef), chunk->numCorners + 1, &chunk->cornerCap, chunk->growthFactor, chunk->allocator);
+				if(chunk->error != QOBJ_SUCCESS)
+					return NULL;
+
+				chunk->corners[chunk->numCorners++] = vert;
+				attribs = qobj_read_vertex_ref(&cur, lineEnd, counts, &vert);
+			}
+
+			face.numCorners = chunk->numCorners - face.firstCorner;
+			if(face.numCorners < 3)
+			{
+				chunk->error = QOBJ_ERROR_INVALID_FILE;
+				return NULL;
+			}
+
+			//add face:
+			//---------------
+			chunk->error = qobj_maybe_resize_array((void**)&chunk->faces, sizeof(QOBJchunkFace), chunk->numFaces + 1, &chunk->faceCap, chunk->growthFactor, chunk->allocator);
+			if(chunk->error != QOBJ_SUCCESS)
+				return NULL;
+
+			chunk->faces[chunk->numFaces++] = face;
+		}
+		else if(keyword == QOBJ_OBJ_KEYWORD_USEMTL)
+		{
+			chunk->error = qobj_maybe_resize_array((void**)&chunk->materials, QOBJ_MAX_TOKEN_LEN, chunk->numMaterials + 1, &chunk->materialCap, chunk->growthFactor, chunk->allocator);
+			if(chunk->error != QOBJ_SUCCESS)
+				return NULL;
+
+			curMaterial = chunk->numMaterials++;
+			qobj_rest_of_line(&cur, lineEnd, &chunk->materials[curMaterial * QOBJ_MAX_TOKEN_LEN]);
+		}
+		else if(keyword != QOBJ_OBJ_KEYWORD_NONE && keyword != QOBJ_OBJ_KEYWORD_IGNORED)
+		{
+			chunk->error = QOBJ_ERROR_UNSUPPORTED_DATA_TYPE;
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+//runs [func] on every chunk, each on its own thread
+void qobj_chunks_run(uint32_t numChunks, QOBJchunk* chunks, void* (*func)(void*), const QOBJallocator* allocator)
+{
+#ifdef QOBJ_THREADS
+	pthread_t* threads = (pthread_t*)qobj_alloc(allocator, numChunks * sizeof(pthread_t));
+	int32_t* started = (int32_t*)qobj_alloc(allocator, numChunks * sizeof(int32_t));
+	if(threads && started)
+	{
+		//the calling thread takes the first chunk, any chunk whose thread cannot be started is run here too
+		for(uint32_t i = 1; i < numChunks; i++)
+			started[i] = pthread_create(&threads[i], NULL, func, &chunks[i]) == 0;
+
+		func(&chunks[0]);
+
+		for(uint32_t i = 1; i < numChunks; i++)
+		{
+			if(started[i])
+				pthread_join(threads[i], NULL);
+			else
+				func(&chunks[i]);
+		}
+
+		qobj_free(allocator, threads);
+		qobj_free(allocator, started);
+		return;
+	}
+
+	qobj_free(allocator, threads);
+	qobj_free(allocator, started);
+#else
+	(void)allocator;
+#endif
+
+	for(uint32_t i = 0; i < numChunks; i++)
+		func(&chunks[i]);
+}
+
+void qobj_chunk_free(QOBJchunk chunk)
+{
+	qobj_free(chunk.allocator, chunk.faces);
+	qobj_free(chunk.allocator, chunk.corners);
+	qobj_free(chunk.allocator, chunk.materials);
+}
+
+//----------------------------------------------------------------------//
+//OBJ LOAD FUNCTIONS:
+
+QOBJloadOptions qobj_default_load_options(void)
+{
+	QOBJloadOptions options;
+	options.flags = 0;
+	options.numThreads = 0;
+	options.weldPosEpsilon = 1e-5f;
+	options.weldNormalEpsilon = 1e-3f;
+	options.weldTexCoordEpsilon = 1e-5f;
+	options.positionCap = 32;
+	options.normalCap = 32;
+	options.texCoordCap = 32;
+	options.vertexCap = 32;
+	options.indexCap = 32;
+	options.mapCap = 32;
+	options.growthFactor = 2.0f;
+	options.context = NULL;
+	options.stats = NULL;
+	options.allocator = NULL;
+
+	return options;
+}
+
+//sets [curMesh] to the mesh using [material], creating it if it does not exist yet
+QOBJerror qobj_get_mesh(const char* material, uint32_t spec, const QOBJloadOptions* options, const QOBJpreflight* preflight, uint32_t* curMesh,
+                        QOBJrecycledMeshes* recycled, uint32_t* numMeshes, QOBJmesh** meshes, QOBJcontext* context)
+{
+	uint32_t flags = options->flags;
+	const QOBJallocator* allocator = qobj_get_allocator(options->allocator);
+
+	if(*curMesh != UINT32_MAX)
+		return QOBJ_SUCCESS;
+
+	//try to find an existing mesh with the same material:
+	//---------------
+	for(uint32_t i = 0; i < *numMeshes; i++)
+	{
+		if(strcmp(material, (*meshes)[i].material) == 0)
+		{
+			*curMesh = i;
+			return QOBJ_SUCCESS;
+		}
+	}
+
+	//allocate mem and create new mesh:
+	//---------------
+	uint32_t meshCap = *numMeshes > 0 ? *numMeshes : 1; //a serial load allocates room for 1 mesh up front
+	QOBJmesh* newMeshes = (QOBJmesh*)qobj_realloc(allocator, *meshes, meshCap * sizeof(QOBJmesh), (*numMeshes + 1) * sizeof(QOBJmesh));
+	if(!newMeshes)
+		return QOBJ_ERROR_OUT_OF_MEM;
+	*meshes = newMeshes;
+
+	if(*numMeshes == context->builderCap) //new builders are zeroed, older ones keep their buffers
+	{
+		uint32_t newCap = context->builderCap > 0 ? context->builderCap * 2 : 4;
+		QOBJmeshBuilder* newBuilders = (QOBJmeshBuilder*)qobj_realloc(&context->allocator, context->builders,
+			context->builderCap * sizeof(QOBJmeshBuilder), newCap * sizeof(QOBJmeshBuilder));
+		if(!newBuilders)
+			return QOBJ_ERROR_OUT_OF_MEM;
+
+		memset(&newBuilders[context->builderCap], 0, (newCap - context->builderCap) * sizeof(QOBJmeshBuilder));
+		context->builders = newBuilders;
+		context->builderCap = newCap;
+	}
+
+	QOBJmeshBuilder* builder = &context->builders[*numMeshes];
+	builder->growthFactor = options->growthFactor;
+
+	//when vertices are shared, every face is built in the first mesh and later meshes only hold a material:
+	//---------------
+	int32_t shared = (flags & QOBJ_LOAD_SHARED_VERTICES) != 0;
+	if(shared && (flags & QOBJ_LOAD_NO_INDICES)) //ranges need an index buffer
+		flags = (flags & ~(uint32_t)QOBJ_LOAD_NO_INDICES) | QOBJ_LOAD_NO_DEDUP;
+
+	if(shared && *numMeshes > 0)
+	{
+		QOBJerror meshCreateError = qobj_mesh_create(&(*meshes)[*numMeshes], spec, material, 0, NULL, allocator);
+		if(meshCreateError != QOBJ_SUCCESS)
+			return meshCreateError;
+
+		builder->flags = flags;
+		builder->numCorners = 0;
+		builder->numRuns = 0;
+
+		*curMesh = (*numMeshes)++;
+		return QOBJ_SUCCESS;
+	}
+
+	uint32_t vertexCap, indexCap, mapCap;
+	qobj_preflight_mesh_caps(preflight, shared ? NULL : material, options, &vertexCap, &indexCap, &mapCap);
+
+	if(flags & (QOBJ_LOAD_NO_DEDUP | QOBJ_LOAD_NO_INDICES)) //every corner is a vertex
+		vertexCap = indexCap;
+	if(flags & QOBJ_LOAD_NO_INDICES)
+		indexCap = 0;
+
+	QOBJerror meshCreateError = qobj_mesh_create(&(*meshes)[*numMeshes], spec, material, indexCap, qobj_recycled_find(recycled, material), allocator);
+	if(meshCreateError != QOBJ_SUCCESS)
+		return meshCreateError;
+
+	//keys start packed unless the attribute counts already show an index too large for them:
+	uint32_t maxIndex = preflight->numPositions;
+	if(preflight->numNormals > maxIndex)
+		maxIndex = preflight->numNormals;
+	if(preflight->numTexCoords > maxIndex)
+		maxIndex = preflight->numTexCoords;
+	int32_t packedKeys = (maxIndex >> QOBJ_HASHMAP_PACKED_BITS) == 0;
+
+	meshCreateError = qobj_builder_reset(builder, flags, vertexCap, mapCap, packedKeys, indexCap, &context->allocator, allocator);
+	if(meshCreateError != QOBJ_SUCCESS)
+	{
+		qobj_mesh_free((*meshes)[*numMeshes], allocator);
+		return meshCreateError;
+	}
+
+#ifdef QOBJ_STATS
+	if(!(builder->flags & (QOBJ_LOAD_SORT_DEDUP | QOBJ_LOAD_NO_DEDUP | QOBJ_LOAD_NO_INDICES)))
+	{
+		builder->map.stats = options->stats;
+		qobj_stats_add_bytes(options->stats, qobj_hashmap_bytes(&builder->map));
+	}
+#endif
+
+	*curMesh = (*numMeshes)++;
+	return QOBJ_SUCCESS;
+}
+
+QOBJerror qobj_load_obj_parallel(QOBJstream* stream, const QOBJloadOptions* options, uint32_t numChunks, QOBJrecycledMeshes* recycled,
+                                 uint32_t* numMeshes, QOBJmesh** meshes)
+{
+	*numMeshes = 0;
+	*meshes = NULL;
+
+	QOBJcontext localContext; //used if the caller does not keep one
+	QOBJcontext* context = qobj_context_for_load(options, &localContext);
+
+	QOBJchunk* chunks = (QOBJchunk*)qobj_alloc(&context->allocator, numChunks * sizeof(QOBJchunk));
+	if(!chunks)
+	{
+		if(context == &localContext)
+			qobj_context_release(&localContext);
+
+		return QOBJ_ERROR_OUT_OF_MEM;
+	}
+
+	qobj_chunks_split(stream->cur, stream->end, numChunks, chunks);
+	for(uint32_t i = 0; i < numChunks; i++)
+	{
+		chunks[i].allocator = &context->allocator;
+		chunks[i].growthFactor = options->growthFactor;
+	}
+
+	//count attributes in each chunk, then give each chunk its range of the attribute arrays:
+	//---------------
+	qobj_chunks_run(numChunks, chunks, qobj_chunk_count, &context->allocator);
+
+	QOBJvertexRef total = {0, 0, 0};
+	for(uint32_t i = 0; i < numChunks; i++)
+	{
+		chunks[i].offsets = total;
+
+		total.pos      += chunks[i].counts.pos;
+		total.normal   += chunks[i].counts.normal;
+		total.texCoord += chunks[i].counts.texCoord;
+	}
+
+	QOBJerror errorCode = qobj_context_reserve(context, total.pos + 1, total.normal + 1, total.texCoord + 1);
+
+	float* positions = context->positions;
+	float* normals   = context->normals;
+	float* texCoords = context->texCoords;
+
+	//parse attributes and faces in each chunk, stopping at the first error in the file:
+	//---------------
+	if(errorCode == QOBJ_SUCCESS)
+	{
+		for(uint32_t i = 0; i < numChunks; i++)
+		{
+			chunks[i].positions = positions;
+			chunks[i].normals = normals;
+			chunks[i].texCoords = texCoords;
+		}
+
+		qobj_chunks_run(numChunks, chunks, qobj_chunk_parse, &context->allocator);
+
+		for(uint32_t i = 0; i < numChunks; i++)
+		{
+			if(chunks[i].error != QOBJ_SUCCESS)
+			{
+				errorCode = chunks[i].error;
+				break;
+			}
+		}
+	}
+
+	//add faces to meshes in file order, so vertices are deduplicated exactly as in a serial load:
+	//---------------
+	QOBJpreflight preflight = {0, 0, 0, 0, NULL}; //per-material caps are not known, meshes start small and grow
+	preflight.numPositions = total.pos;
+	preflight.numNormals = total.normal;
+	preflight.numTexCoords = total.texCoord;
+
+	char curMaterial[QOBJ_MAX_TOKEN_LEN] = {0};
+	uint32_t curMesh = UINT32_MAX;
+
+	for(uint32_t i = 0; i < numChunks && errorCode == QOBJ_SUCCESS; i++)
+	{
+		QOBJchunk* chunk = &chunks[i];
+		uint32_t chunkMaterial = UINT32_MAX;
+
+		for(uint32_t j = 0; j < chunk->numFaces; j++)
+		{
+			QOBJchunkFace face = chunk->faces[j];
+			if(face.material != chunkMaterial)
+			{
+				chunkMaterial = face.material;
+
+				memcpy(curMaterial, &chunk->materials[chunkMaterial * QOBJ_MAX_TOKEN_LEN], QOBJ_MAX_TOKEN_LEN);
+				curMesh = UINT32_MAX;
+			}
+
+			errorCode = qobj_get_mesh(curMaterial, face.spec, options, &preflight, &curMesh, recycled, numMeshes, meshes, context);
+			if(errorCode != QOBJ_SUCCESS)
+				break;
+
+			uint32_t buildMesh = (options->flags & QOBJ_LOAD_SHARED_VERTICES) ? 0 : curMesh;
+			QOBJmesh* mesh = &(*meshes)[buildMesh];
+			QOBJmeshBuilder* builder = &context->builders[buildMesh];
+
+			if(options->flags & QOBJ_LOAD_SHARED_VERTICES) //the shared vertices hold every attribute any face has
+				qobj_mesh_widen(mesh, face.spec, builder->meshAllocator);
+
+			QOBJvertexRef* corners = &chunk->corners[face.firstCorner];
+			for(uint32_t k = 2; k < face.numCorners; k++)
+			{
+				errorCode = qobj_add_triangle(mesh, builder, corners[0], corners[k - 1], corners[k]);
+				if(errorCode != QOBJ_SUCCESS)
+					break;
+			}
+
+			if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_SHARED_VERTICES))
+				errorCode = qobj_builder_add_run(builder, curMesh, qobj_builder_num_indices(mesh, builder));
+
+			if(errorCode != QOBJ_SUCCESS)
+				break;
+		}
+
+		//a "usemtl" after the chunk's last face still applies to the next chunk
+		if(chunk->numMaterials > 0 && chunkMaterial != chunk->numMaterials - 1)
+		{
+			memcpy(curMaterial, &chunk->materials[(chunk->numMaterials - 1) * QOBJ_MAX_TOKEN_LEN], QOBJ_MAX_TOKEN_LEN);
+			curMesh = UINT32_MAX;
+		}
+	}
+
+	//finish meshes:
+	//---------------
+	for(uint32_t i = 0; i < *numMeshes && errorCode == QOBJ_SUCCESS; i++)
+	{
+		errorCode = qobj_builder_finish(&(*meshes)[i], &context->builders[i], total, positions, texCoords, normals);
+		if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_WELD))
+			errorCode = qobj_mesh_weld(&(*meshes)[i], options, &context->allocator);
+	}
+
+	if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_SHARED_VERTICES) && *numMeshes > 0)
+		errorCode = qobj_builder_split_shared(*numMeshes, *meshes, &context->builders[0]);
+
+	if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_SHRINK_TO_FIT) && !(options->flags & QOBJ_LOAD_SINGLE_BLOCK)) //a block is already exact
+		qobj_meshes_shrink(*numMeshes, *meshes, (options->flags & QOBJ_LOAD_SHARED_VERTICES) != 0, qobj_get_allocator(options->allocator));
+
+	if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_SINGLE_BLOCK) && *numMeshes > 0)
+		errorCode = qobj_meshes_pack(*numMeshes, meshes, (options->flags & QOBJ_LOAD_SHARED_VERTICES) != 0, qobj_get_allocator(options->allocator));
+
+	//cleanup:
+	//---------------
+#ifdef QOBJ_STATS
+	qobj_stats_finish(options->stats);
+#endif
+
+	if(errorCode != QOBJ_SUCCESS)
+	{
+		qobj_meshes_free(*numMeshes, *meshes, qobj_get_allocator(options->allocator)); //never packed if the load failed
+		*numMeshes = 0;
+		*meshes = NULL;
+	}
+
+	for(uint32_t i = 0; i < numChunks; i++)
+		qobj_chunk_free(chunks[i]);
+
+	qobj_free(&context->allocator, chunks);
 
-	//add vertices + indices:
-	//---------------
-	qobj_add_vertex(mesh, map, v0, positions, texCoords, normals);
-	qobj_add_vertex(mesh, map, v1, positions, texCoords, normals);
-	qobj_add_vertex(mesh, map, v2, positions, texCoords, normals);
+	if(context == &localContext)
+		qobj_context_release(&localContext);
 
-	//return:
-	return QOBJ_SUCCESS;
+	return errorCode;
 }
 
-//----------------------------------------------------------------------//
-//OBJ LOAD FUNCTION:
-
-QOBJerror qobj_load_obj(const char* path, uint32_t* numMeshes, QOBJmesh** meshes)
+//loads from [stream], taking the buffers of [recycled] meshes (may be NULL) before allocating new ones
+QOBJerror qobj_load_obj_stream(QOBJstream* stream, const QOBJloadOptions* options, QOBJrecycledMeshes* recycled, uint32_t* numMeshes, QOBJmesh** meshes)
 {
 	*numMeshes = 0;
 	*meshes = NULL;
 
-	//ensure file is valid and able to be opened:
+#ifdef QOBJ_STATS
+	if(options->stats)
+		memset(options->stats, 0, sizeof(QOBJdedupStats));
+#endif
+
+	//parse on multiple threads if requested, only possible when the whole file is in memory:
 	//---------------
-	uint32_t pathLen = (uint32_t)strlen(path);
-	if(pathLen < 4 || strcmp(&path[pathLen - 4], ".obj") != 0)
-		return QOBJ_ERROR_INVALID_FILE;
+	if((options->flags & QOBJ_LOAD_PARALLEL) && !stream->reader)
+	{
+		uint32_t numChunks = qobj_num_chunks(options, stream->end - stream->cur);
+		if(numChunks > 1)
+			return qobj_load_obj_parallel(stream, options, numChunks, recycled, numMeshes, meshes);
+	}
 
-	FILE* fptr;
-	if(fopen_s(&fptr, path, "r") != 0)
-		return QOBJ_ERROR_IO;
+	//count everything up front if requested, only possible when the whole file is in memory:
+	//---------------
+	int32_t preflighted = (options->flags & QOBJ_LOAD_PREFLIGHT) && !stream->reader;
+
+	QOBJcontext localContext; //used if the caller does not keep one
+	QOBJcontext* context = qobj_context_for_load(options, &localContext);
+
+	QOBJpreflight preflight = {0, 0, 0, 0, NULL};
+	if(preflighted)
+	{
+		QOBJstream preflightStream = *stream;
+		QOBJerror preflightError = qobj_preflight_count(&preflightStream, &preflight, &context->allocator);
+		if(preflightError != QOBJ_SUCCESS)
+		{
+			qobj_preflight_free(preflight, &context->allocator);
+			if(context == &localContext)
+				qobj_context_release(&localContext);
+
+			return preflightError;
+		}
+	}
 
 	//allocate memory:
 	//---------------
 	uint32_t positionSize = 0 , normalSize = 0 , texCoordSize = 0;
-	uint32_t positionCap  = 32, normalCap  = 32, texCoordCap  = 32;
-	float* positions = (float*)QOBJ_MALLOC(positionCap * sizeof(float) * QOBJ_ATTRIB_SIZE_POSITION);
-	float* normals   = (float*)QOBJ_MALLOC(normalCap   * sizeof(float) * QOBJ_ATTRIB_SIZE_NORMAL);
-	float* texCoords = (float*)QOBJ_MALLOC(texCoordCap * sizeof(float) * QOBJ_ATTRIB_SIZE_TEX_COORDS);
+	uint32_t positionCap  = options->positionCap, normalCap = options->normalCap, texCoordCap = options->texCoordCap;
+	if(positionCap == 0) positionCap = 1; //each attribute is read before its array grows, so there must be room for one
+	if(normalCap   == 0) normalCap   = 1;
+	if(texCoordCap == 0) texCoordCap = 1;
+	if(preflighted) //attribute arrays grow when full, so leave room for 1 more
+	{
+		positionCap = preflight.numPositions + 1;
+		normalCap   = preflight.numNormals   + 1;
+		texCoordCap = preflight.numTexCoords + 1;
+	}
 
-	*numMeshes = 0;
-	*meshes = (QOBJmesh*)QOBJ_MALLOC(sizeof(QOBJmesh));
-	QOBJvertexHashmap* meshVertexMaps = (QOBJvertexHashmap*)QOBJ_MALLOC(sizeof(QOBJvertexHashmap));
+	QOBJerror reserveError = qobj_context_reserve(context, positionCap, normalCap, texCoordCap);
+
+	//the arrays may be larger than asked for, which only means they grow later:
+	float* positions = context->positions; positionCap = context->positionCap;
+	float* normals   = context->normals;   normalCap   = context->normalCap;
+	float* texCoords = context->texCoords; texCoordCap = context->texCoordCap;
+
+	const QOBJallocator* allocator = qobj_get_allocator(options->allocator);
+	*meshes = (QOBJmesh*)qobj_alloc(allocator, sizeof(QOBJmesh));
 
 	//ensure memory was properly allocated:
 	//---------------
-	if(!positions || !normals || !texCoords || !*meshes || !meshVertexMaps)
+	if(reserveError != QOBJ_SUCCESS || !*meshes)
 	{
-		QOBJ_FREE(positions);
-		QOBJ_FREE(normals);
-		QOBJ_FREE(texCoords);
+		qobj_free(allocator, *meshes);
+		*meshes = NULL;
 
-		QOBJ_FREE(meshes);
-		QOBJ_FREE(meshVertexMaps);
-
-		fclose(fptr);
+		qobj_preflight_free(preflight, &context->allocator);
+		if(context == &localContext)
+			qobj_context_release(&localContext);
 
 		return QOBJ_ERROR_OUT_OF_MEM;
 	}
@@ -621,190 +4196,73 @@ QOBJerror qobj_load_obj(const char* path, uint32_t* numMeshes, QOBJmesh** meshes
 	QOBJerror errorCode = QOBJ_SUCCESS;
 
 	char curToken[QOBJ_MAX_TOKEN_LEN];
-	char curTokenEnd;
+	const char* lineStart;
+	const char* lineEnd;
 
-	char curMaterial[QOBJ_MAX_TOKEN_LEN] = {}; //no material specified (yet)
-	uint32_t curMesh = UINT32_MAX;             //no working mesh (yet)
+	char curMaterial[QOBJ_MAX_TOKEN_LEN] = {0}; //no material specified (yet)
+	uint32_t curMesh = UINT32_MAX;              //no working mesh (yet)
 
-	while(1)
+	while(qobj_next_line(stream, &lineStart, &lineEnd))
 	{
-		qobj_next_token(fptr, curToken, &curTokenEnd);
+		const char* cur = lineStart;
 
-		if(curTokenEnd == EOF)
-			break;
-
-		if(curToken[0] == '\0')
-			continue;
+		QOBJobjKeyword keyword = qobj_read_obj_keyword(&cur, lineEnd);
 
-		if(curToken[0] == '#'         || strcmp(curToken, "o") == 0 || 
-		   strcmp(curToken, "g") == 0 || strcmp(curToken, "s") == 0 || //comments / ignored commands
-		   strcmp(curToken, "mtllib") == 0)
-		{
-			if(isspace(curTokenEnd))
-				qobj_fgets(fptr, curToken, &curTokenEnd);
-		}
-		else if(strcmp(curToken, "v") == 0)
+		if(keyword == QOBJ_OBJ_KEYWORD_V)
 		{
 			uint32_t insertIdx = (uint32_t)positionSize++ * QOBJ_ATTRIB_SIZE_POSITION;
+			qobj_read_floats(&cur, lineEnd, &positions[insertIdx], QOBJ_ATTRIB_SIZE_POSITION);
 
-			fscanf_s(fptr, "%f %f %f\n", 
-				&positions[insertIdx + 0], 
-				&positions[insertIdx + 1], 
-				&positions[insertIdx + 2]
-			);
-
-			errorCode = qobj_maybe_resize_array((void**)&positions, sizeof(float) * QOBJ_ATTRIB_SIZE_POSITION, positionSize, &positionCap);
+			errorCode = qobj_maybe_resize_array((void**)&positions, sizeof(float) * QOBJ_ATTRIB_SIZE_POSITION, positionSize, &positionCap, options->growthFactor, &context->allocator);
 			if(errorCode != QOBJ_SUCCESS)
 				break;
 		}
-		else if(strcmp(curToken, "vn") == 0)
+		else if(keyword == QOBJ_OBJ_KEYWORD_VN)
 		{
 			uint32_t insertIdx = (uint32_t)normalSize++ * QOBJ_ATTRIB_SIZE_NORMAL;
+			qobj_read_floats(&cur, lineEnd, &normals[insertIdx], QOBJ_ATTRIB_SIZE_NORMAL);
 
-			fscanf_s(fptr, "%f %f %f\n", 
-				&normals[insertIdx + 0], 
-				&normals[insertIdx + 1], 
-				&normals[insertIdx + 2]
-			);
-
-			errorCode = qobj_maybe_resize_array((void**)&normals, sizeof(float) * QOBJ_ATTRIB_SIZE_NORMAL, normalSize, &normalCap);
+			errorCode = qobj_maybe_resize_array((void**)&normals, sizeof(float) * QOBJ_ATTRIB_SIZE_NORMAL, normalSize, &normalCap, options->growthFactor, &context->allocator);
 			if(errorCode != QOBJ_SUCCESS)
 				break;
 		}
-		else if(strcmp(curToken, "vt") == 0)
+		else if(keyword == QOBJ_OBJ_KEYWORD_VT)
 		{
-			//TODO: v is optional, account for this
-
 			uint32_t insertIdx = (uint32_t)texCoordSize++ * QOBJ_ATTRIB_SIZE_TEX_COORDS;
+			qobj_read_floats(&cur, lineEnd, &texCoords[insertIdx], QOBJ_ATTRIB_SIZE_TEX_COORDS); //a missing v defaults to 0
 
-			fscanf_s(fptr, "%f %f\n", 
-				&texCoords[insertIdx + 0], 
-				&texCoords[insertIdx + 1]
-			);
-
-			errorCode = qobj_maybe_resize_array((void**)&texCoords, sizeof(float) * QOBJ_ATTRIB_SIZE_TEX_COORDS, texCoordSize, &texCoordCap);
+			errorCode = qobj_maybe_resize_array((void**)&texCoords, sizeof(float) * QOBJ_ATTRIB_SIZE_TEX_COORDS, texCoordSize, &texCoordCap, options->growthFactor, &context->allocator);
 			if(errorCode != QOBJ_SUCCESS)
 				break;
 		}
-		else if(strcmp(curToken, "f") == 0)
+		else if(keyword == QOBJ_OBJ_KEYWORD_F)
 		{
 			//read first vertex + determine format:
 			//---------------
+			QOBJvertexRef counts = {positionSize, normalSize, texCoordSize};
 			QOBJvertexRef firstVertex;
 
-			QOBJvertexSpecification spec;
-			uint32_t numRead = fscanf_s(fptr, "%d/%d/%d", &firstVertex.pos, &firstVertex.texCoord, &firstVertex.normal);
-			
-			switch(numRead)
-			{
-			case 1:
-			{
-				char nextCh = fgetc(fptr);
-				if(nextCh == '/')
-				{
-					fscanf_s(fptr, "%d", &firstVertex.normal);
-
-					spec = QOBJ_VERTEX_SPEC_POSITION_NORMAL;	
-					firstVertex.texCoord = 0;
-				}
-				else
-				{
-					spec = QOBJ_VERTEX_SPEC_POSITION;
-					firstVertex.texCoord = 0;
-					firstVertex.normal = 0;
-				}
-
-				break;
-			}
-			case 2:
-			{
-				spec = QOBJ_VERTEX_SPEC_POSITION_TEX_COORD;
-				firstVertex.normal = 0;
-				break;
-			}
-			case 3:
-			{
-				spec = QOBJ_VERTEX_SPEC_POSITION_TEX_COORD_NORMAL;
-				break;
-			}
-			case 0:
-			default: //nothing read, "f" exists with no params
-			{
-				spec = (QOBJvertexSpecification)0;
-				break;
-			}
-			}
-
-			if(spec == 0)
+			uint32_t firstAttribs = qobj_read_vertex_ref(&cur, lineEnd, counts, &firstVertex);
+			if(firstAttribs == 0 || firstAttribs == QOBJ_VERTEX_REF_INVALID) //nothing valid read, "f" exists with no params or a bad index
 			{
 				errorCode = QOBJ_ERROR_INVALID_FILE;
 				break;
 			}
 
-			//if no mesh is active yet, try to find an existing mesh with the same material:
-			//---------------
-			if(curMesh == UINT32_MAX)
-				for(uint32_t i = 0; i < *numMeshes; i++)
-				{
-					if(strcmp(curMaterial, meshes[i]->material) == 0)
-					{
-						curMesh = i;
-						break;
-					}
-				}
+			//every spec is a valid set of attribs, see definition
+			QOBJvertexSpecification spec = (QOBJvertexSpecification)firstAttribs;
 
-			//if no valid active mesh was found, create a new one:
+			//find or create the mesh for the current material:
 			//---------------
-			if(curMesh == UINT32_MAX)
-			{
-				//set curMesh:
-				curMesh = (uint32_t)*numMeshes;
-
-				//allocate mem and create new mesh:
-				QOBJmesh* newMeshes = (QOBJmesh*)QOBJ_REALLOC(*meshes, (*numMeshes + 1) * sizeof(QOBJmesh));
-				if(!newMeshes)
-				{
-					errorCode = QOBJ_ERROR_OUT_OF_MEM;
-					break;
-				}
-				else
-					*meshes = newMeshes;
-
-				QOBJvertexHashmap* newMeshVertexMaps = (QOBJvertexHashmap*)QOBJ_REALLOC(meshVertexMaps, (*numMeshes + 1) * sizeof(QOBJvertexHashmap));
-				if(!newMeshVertexMaps)
-				{
-					errorCode = QOBJ_ERROR_OUT_OF_MEM;
-					break;
-				}
-				else
-					meshVertexMaps = newMeshVertexMaps;
-
-				//every spec is a valid set of attribs, see definition
-				QOBJerror meshCreateError = qobj_mesh_create(&(*meshes)[curMesh], spec, curMaterial);
-				if(meshCreateError != QOBJ_SUCCESS)
-				{
-					errorCode = meshCreateError;
-					break;
-				}
-
-				meshCreateError = qobj_hashmap_create(&meshVertexMaps[curMesh]);
-				if(meshCreateError != QOBJ_SUCCESS)
-				{
-					qobj_mesh_free((*meshes)[curMesh]);
-
-					errorCode = meshCreateError;
-					break;
-				}
-
-				//increment num meshes:
-				(*numMeshes)++;
-			}
+			errorCode = qobj_get_mesh(curMaterial, spec, options, &preflight, &curMesh, recycled, numMeshes, meshes, context);
+			if(errorCode != QOBJ_SUCCESS)
+				break;
 
 			//read next 2 vertices:
 			//---------------
 			QOBJvertexRef v1, v2;
 
-			if(qobj_read_vertex_ref(fptr, spec, &v1) == 0 || qobj_read_vertex_ref(fptr, spec, &v2) == 0)
+			if(qobj_read_vertex_ref(&cur, lineEnd, counts, &v1) != spec || qobj_read_vertex_ref(&cur, lineEnd, counts, &v2) != spec)
 			{
 				errorCode = QOBJ_ERROR_INVALID_FILE;
 				break;
@@ -812,32 +4270,49 @@ QOBJerror qobj_load_obj(const char* path, uint32_t* numMeshes, QOBJmesh** meshes
 
 			//add vertices to mesh and continue reading, triangulating face:
 			//---------------
-			QOBJmesh* mesh = &(*meshes)[curMesh];
-			QOBJvertexHashmap* map = &meshVertexMaps[curMesh]; 
+			uint32_t buildMesh = (options->flags & QOBJ_LOAD_SHARED_VERTICES) ? 0 : curMesh;
+			QOBJmesh* mesh = &(*meshes)[buildMesh];
+			QOBJmeshBuilder* builder = &context->builders[buildMesh];
+
+			if(options->flags & QOBJ_LOAD_SHARED_VERTICES) //the shared vertices hold every attribute any face has
+				qobj_mesh_widen(mesh, spec, builder->meshAllocator);
 
 			while(1)
 			{
-				errorCode = qobj_add_triangle(mesh, map, firstVertex, v1, v2, positions, texCoords, normals);
+				errorCode = qobj_add_triangle(mesh, builder, firstVertex, v1, v2);
 				if(errorCode != QOBJ_SUCCESS)
 					break;
 			
 				v1 = v2;
 
-				int32_t readResult = qobj_read_vertex_ref(fptr, spec, &v2);
-				if(readResult == 0 || readResult == EOF)
+				uint32_t attribs = qobj_read_vertex_ref(&cur, lineEnd, counts, &v2);
+				if(attribs == 0)
+					break;
+
+				if(attribs != spec) //all vertices of a face must have the same format, and be valid
+				{
+					errorCode = QOBJ_ERROR_INVALID_FILE;
 					break;
+				}
 			}
 
+			if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_SHARED_VERTICES))
+				errorCode = qobj_builder_add_run(builder, curMesh, qobj_builder_num_indices(mesh, builder));
+
 			if(errorCode != QOBJ_SUCCESS)
 				break;
 		}
-		else if(strcmp(curToken, "usemtl") == 0)
+		else if(keyword == QOBJ_OBJ_KEYWORD_USEMTL)
 		{
-			qobj_fgets(fptr, curToken, &curTokenEnd);
+			qobj_rest_of_line(&cur, lineEnd, curToken);
 			
-			strcpy_s(curMaterial, QOBJ_MAX_TOKEN_LEN, curToken);
+			memcpy(curMaterial, curToken, QOBJ_MAX_TOKEN_LEN);
 			curMesh = UINT32_MAX;
 		}
+		else if(keyword == QOBJ_OBJ_KEYWORD_NONE || keyword == QOBJ_OBJ_KEYWORD_IGNORED) //blank lines, comments / ignored commands
+		{
+			continue;
+		}
 		else
 		{
 			errorCode = QOBJ_ERROR_UNSUPPORTED_DATA_TYPE;
@@ -845,95 +4320,264 @@ QOBJerror qobj_load_obj(const char* path, uint32_t* numMeshes, QOBJmesh** meshes
 		}
 	}
 
-	//cleanup:
+	if(errorCode == QOBJ_SUCCESS)
+		errorCode = stream->error;
+
+	//finish meshes:
 	//---------------
-	for(uint32_t i = 0; i < *numMeshes; i++)
-		qobj_hashmap_free(meshVertexMaps[i]);
+	QOBJvertexRef counts = {positionSize, normalSize, texCoordSize};
+	for(uint32_t i = 0; i < *numMeshes && errorCode == QOBJ_SUCCESS; i++)
+	{
+		errorCode = qobj_builder_finish(&(*meshes)[i], &context->builders[i], counts, positions, texCoords, normals);
+		if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_WELD))
+			errorCode = qobj_mesh_weld(&(*meshes)[i], options, &context->allocator);
+	}
+
+	if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_SHARED_VERTICES) && *numMeshes > 0)
+		errorCode = qobj_builder_split_shared(*numMeshes, *meshes, &context->builders[0]);
+
+	if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_SHRINK_TO_FIT) && !(options->flags & QOBJ_LOAD_SINGLE_BLOCK)) //a block is already exact
+		qobj_meshes_shrink(*numMeshes, *meshes, (options->flags & QOBJ_LOAD_SHARED_VERTICES) != 0, qobj_get_allocator(options->allocator));
 
-	QOBJ_FREE(meshVertexMaps);
+	if(errorCode == QOBJ_SUCCESS && (options->flags & QOBJ_LOAD_SINGLE_BLOCK) && *numMeshes > 0)
+		errorCode = qobj_meshes_pack(*numMeshes, meshes, (options->flags & QOBJ_LOAD_SHARED_VERTICES) != 0, qobj_get_allocator(options->allocator));
+
+	//cleanup, giving the attribute arrays back to the context as they may have moved while growing:
+	//---------------
+#ifdef QOBJ_STATS
+	qobj_stats_finish(options->stats);
+#endif
+
+	context->positions = positions; context->positionCap = positionCap;
+	context->normals   = normals;   context->normalCap   = normalCap;
+	context->texCoords = texCoords; context->texCoordCap = texCoordCap;
 
 	if(errorCode != QOBJ_SUCCESS)
 	{
-		qobj_free_obj(*numMeshes, *meshes);
+		qobj_meshes_free(*numMeshes, *meshes, qobj_get_allocator(options->allocator)); //never packed if the load failed
 		*numMeshes = 0;
+		*meshes = NULL;
 	}
 
-	QOBJ_FREE(positions);
-	QOBJ_FREE(normals);
-	QOBJ_FREE(texCoords);
+	qobj_preflight_free(preflight, &context->allocator);
+	if(context == &localContext)
+		qobj_context_release(&localContext);
 
-	fclose(fptr);
 	return errorCode;
 }
 
-void qobj_free_obj(uint32_t numMeshes, QOBJmesh* meshes)
+//returns QOBJ_ERROR_INVALID_ARGS if [options] can not be loaded with, this also rejects a NaN growth factor
+QOBJerror qobj_check_load_options(const QOBJloadOptions* options)
 {
-	if(meshes == NULL)
-		return;
+	if(!(options->growthFactor > 1.0f && options->growthFactor <= QOBJ_MAX_GROWTH_FACTOR))
+		return QOBJ_ERROR_INVALID_ARGS;
 
-	for(uint32_t i = 0; i < numMeshes; i++)
-		qobj_mesh_free(meshes[i]);
-	
-	QOBJ_FREE(meshes);
+	return QOBJ_SUCCESS;
 }
 
-//----------------------------------------------------------------------//
-//MTL LOAD FUNCTIONS:
+//loads from [reader], taking the buffers of [recycled] meshes (may be NULL) before allocating new ones
+QOBJerror qobj_load_obj_reader(const QOBJreader* reader, const QOBJloadOptions* options, QOBJrecycledMeshes* recycled, uint32_t* numMeshes, QOBJmesh** meshes)
+{
+	*numMeshes = 0;
+	*meshes = NULL;
 
-QOBJerror qobj_load_mtl(const char* path, uint32_t* numMaterials, QOBJmaterial** materials)
+	QOBJerror optionsError = qobj_check_load_options(options);
+	if(optionsError != QOBJ_SUCCESS)
+		return optionsError;
+
+	//the stream's buffer is scratch memory, so it comes from the context if there is one:
+	const QOBJallocator* scratchAllocator = options->context ? &options->context->allocator : qobj_get_allocator(options->allocator);
+
+	QOBJstream stream;
+	QOBJerror streamError = qobj_stream_from_reader(&stream, reader, (options->flags & QOBJ_LOAD_PIPELINED) != 0, scratchAllocator);
+	if(streamError != QOBJ_SUCCESS)
+		return streamError;
+
+	QOBJerror errorCode = qobj_load_obj_stream(&stream, options, recycled, numMeshes, meshes);
+
+	qobj_stream_free(&stream);
+	return errorCode;
+}
+
+//loads from the file at [path], taking the buffers of [recycled] meshes (may be NULL) before allocating new ones
+QOBJerror qobj_load_obj_path(const char* path, const QOBJloadOptions* options, QOBJrecycledMeshes* recycled, uint32_t* numMeshes, QOBJmesh** meshes)
 {
+	*numMeshes = 0;
+	*meshes = NULL;
+
+	QOBJerror optionsError = qobj_check_load_options(options);
+	if(optionsError != QOBJ_SUCCESS)
+		return optionsError;
+
 	//ensure file is valid and able to be opened:
 	//---------------
 	uint32_t pathLen = (uint32_t)strlen(path);
-	if(pathLen < 4 || strcmp(&path[pathLen - 4], ".mtl") != 0)
+	if(pathLen < 4 || strcmp(&path[pathLen - 4], ".obj") != 0)
 		return QOBJ_ERROR_INVALID_FILE;
 
-	FILE* fptr;
-	if(fopen_s(&fptr, path, "r") != 0)
+	//map file into memory if possible, unless reading should overlap with parsing:
+	//---------------
+#ifdef QOBJ_MMAP
+	QOBJfile file;
+	if(!(options->flags & QOBJ_LOAD_PIPELINED) && qobj_file_map(path, &file) == QOBJ_SUCCESS)
+	{
+		QOBJstream stream;
+		qobj_stream_from_memory(&stream, file.data, file.len);
+
+		QOBJerror errorCode = qobj_load_obj_stream(&stream, options, recycled, numMeshes, meshes);
+
+		qobj_file_unmap(file);
+		return errorCode;
+	}
+#endif
+
+	//otherwise, stream file in blocks:
+	//---------------
+	FILE* fptr = qobj_file_open(path);
+	if(!fptr)
 		return QOBJ_ERROR_IO;
 
+	QOBJreader reader = qobj_file_reader(fptr);
+	QOBJerror errorCode = qobj_load_obj_reader(&reader, options, recycled, numMeshes, meshes);
+
+	fclose(fptr);
+	return errorCode;
+}
+
+QOBJerror qobj_load_obj(const char* path, uint32_t* numMeshes, QOBJmesh** meshes)
+{
+	return qobj_load_obj_opts(path, NULL, numMeshes, meshes);
+}
+
+QOBJerror qobj_load_obj_opts(const char* path, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes)
+{
+	QOBJloadOptions defaultOptions = qobj_default_load_options();
+	if(!options)
+		options = &defaultOptions;
+
+	return qobj_load_obj_path(path, options, NULL, numMeshes, meshes);
+}
+
+QOBJerror qobj_reload_obj(const char* path, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes)
+{
+	QOBJloadOptions defaultOptions = qobj_default_load_options();
+	if(!options)
+		options = &defaultOptions;
+
+	const QOBJallocator* allocator = qobj_get_allocator(options->allocator);
+
+	QOBJrecycledMeshes recycled = {*numMeshes, *meshes};
+	if(recycled.numMeshes > 0 && recycled.meshes[0].block) //buffers inside a block can not be taken one at a time
+	{
+		qobj_free(allocator, recycled.meshes[0].block);
+		recycled.numMeshes = 0;
+		recycled.meshes = NULL;
+	}
+
+	//meshes sharing the first mesh's buffers do not own them, so only the first one can hand them out:
+	//---------------
+	for(uint32_t i = 1; i < recycled.numMeshes; i++)
+	{
+		QOBJmesh* mesh = &recycled.meshes[i];
+		if(!mesh->vertices || mesh->vertices != recycled.meshes[0].vertices)
+			continue;
+
+		mesh->vertices = NULL;
+		mesh->indices = NULL;
+	}
+
+	QOBJerror errorCode = qobj_load_obj_path(path, options, &recycled, numMeshes, meshes);
+
+	qobj_meshes_free(recycled.numMeshes, recycled.meshes, allocator);
+	return errorCode;
+}
+
+QOBJerror qobj_load_obj_from_memory(const char* data, size_t len, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes)
+{
+	QOBJloadOptions defaultOptions = qobj_default_load_options();
+	if(!options)
+		options = &defaultOptions;
+
+	*numMeshes = 0;
+	*meshes = NULL;
+
+	QOBJerror optionsError = qobj_check_load_options(options);
+	if(optionsError != QOBJ_SUCCESS)
+		return optionsError;
+
+	QOBJstream stream;
+	qobj_stream_from_memory(&stream, data, len);
+
+	return qobj_load_obj_stream(&stream, options, NULL, numMeshes, meshes);
+}
+
+QOBJerror qobj_load_obj_ex(const QOBJreader* reader, const QOBJloadOptions* options, uint32_t* numMeshes, QOBJmesh** meshes)
+{
+	QOBJloadOptions defaultOptions = qobj_default_load_options();
+	if(!options)
+		options = &defaultOptions;
+
+	return qobj_load_obj_reader(reader, options, NULL, numMeshes, meshes);
+}
+
+void qobj_free_obj(uint32_t numMeshes, QOBJmesh* meshes)
+{
+	qobj_free_obj_opts(numMeshes, meshes, NULL);
+}
+
+void qobj_free_obj_opts(uint32_t numMeshes, QOBJmesh* meshes, const QOBJloadOptions* options)
+{
+	if(meshes == NULL)
+		return;
+
+	const QOBJallocator* allocator = qobj_get_allocator(options ? options->allocator : NULL);
+
+	if(numMeshes > 0 && meshes[0].block) //everything lives in the block starting at the mesh array
+		qobj_free(allocator, meshes[0].block);
+	else
+		qobj_meshes_free(numMeshes, meshes, allocator);
+}
+
+//----------------------------------------------------------------------//
+//MTL LOAD FUNCTIONS:
+
+QOBJerror qobj_load_mtl_stream(QOBJstream* stream, const QOBJallocator* allocator, uint32_t* numMaterials, QOBJmaterial** materials)
+{
 	//allocate memory:
 	//---------------
-	*materials = (QOBJmaterial*)QOBJ_MALLOC(sizeof(QOBJmaterial));
+	*materials = (QOBJmaterial*)qobj_alloc(allocator, sizeof(QOBJmaterial));
 	*numMaterials = 0;
 
 	if(!*materials)
-	{
-		QOBJ_FREE(materials);
 		return QOBJ_ERROR_OUT_OF_MEM;
-	}
 
 	//main loop:
 	//---------------
 	QOBJerror errorCode = QOBJ_SUCCESS;
 
 	char curToken[QOBJ_MAX_TOKEN_LEN];
-	char curTokenEnd;
+	const char* lineStart;
+	const char* lineEnd;
 
 	uint32_t curMaterial = 0;
 
-	while(1)
+	while(qobj_next_line(stream, &lineStart, &lineEnd))
 	{
-		qobj_next_token(fptr, curToken, &curTokenEnd);
+		const char* cur = lineStart;
 
-		if(curTokenEnd == EOF)
-			break;
-
-		if(curToken[0] == '\0')
-			continue;
+		QOBJmtlKeyword keyword = qobj_read_mtl_keyword(&cur, lineEnd);
 
-		if(curToken[0] == '#' || strcmp(curToken, "illum") == 0 ||
-		   strcmp(curToken, "Tf") == 0) //comments / ignored commands
+		if(keyword == QOBJ_MTL_KEYWORD_NONE || keyword == QOBJ_MTL_KEYWORD_IGNORED) //blank lines, comments / ignored commands
 		{
-			if(isspace(curTokenEnd))
-				qobj_fgets(fptr, curToken, &curTokenEnd);
+			continue;
 		}
-		else if(strcmp(curToken, "newmtl") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_NEWMTL)
 		{
-			qobj_fgets(fptr, curToken, &curTokenEnd);
+			qobj_rest_of_line(&cur, lineEnd, curToken);
 
 			curMaterial = *numMaterials;
-			QOBJmaterial* newMaterials = (QOBJmaterial*)QOBJ_REALLOC(*materials, *numMaterials * sizeof(QOBJmaterial));
+			uint32_t materialCap = *numMaterials > 0 ? *numMaterials : 1; //room for 1 material is allocated up front
+			QOBJmaterial* newMaterials = (QOBJmaterial*)qobj_realloc(allocator, *materials, materialCap * sizeof(QOBJmaterial), (*numMaterials + 1) * sizeof(QOBJmaterial));
 			if(!newMaterials)
 			{
 				errorCode = QOBJ_ERROR_OUT_OF_MEM;
@@ -946,102 +4590,186 @@ QOBJerror qobj_load_mtl(const char* path, uint32_t* numMaterials, QOBJmaterial**
 			}
 
 			(*materials)[curMaterial] = qobj_default_material();
-			(*materials)[curMaterial].name = (char*)QOBJ_MALLOC(QOBJ_MAX_TOKEN_LEN * sizeof(char));
-			strcpy_s((*materials)[curMaterial].name, QOBJ_MAX_TOKEN_LEN, curToken);
+			(*materials)[curMaterial].name = (char*)qobj_alloc(allocator, QOBJ_MAX_TOKEN_LEN * sizeof(char));
+			memcpy((*materials)[curMaterial].name, curToken, QOBJ_MAX_TOKEN_LEN);
 		}
-		else if(strcmp(curToken, "Ka") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_KA)
 		{
-			QOBJcolor col;
-			fscanf_s(fptr, "%f %f %f\n", &col.r, &col.g, &col.b);
+			float vals[3];
+			qobj_read_floats(&cur, lineEnd, vals, 3);
+
+			QOBJcolor col = {vals[0], vals[1], vals[2]};
 
 			(*materials)[curMaterial].ambientColor = col;
 		}
-		else if(strcmp(curToken, "Kd") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_KD)
 		{
-			QOBJcolor col;
-			fscanf_s(fptr, "%f %f %f\n", &col.r, &col.g, &col.b);
+			float vals[3];
+			qobj_read_floats(&cur, lineEnd, vals, 3);
+
+			QOBJcolor col = {vals[0], vals[1], vals[2]};
 
 			(*materials)[curMaterial].diffuseColor = col;
 		}
-		else if(strcmp(curToken, "Ks") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_KS)
 		{
-			QOBJcolor col;
-			fscanf_s(fptr, "%f %f %f\n", &col.r, &col.g, &col.b);
+			float vals[3];
+			qobj_read_floats(&cur, lineEnd, vals, 3);
+
+			QOBJcolor col = {vals[0], vals[1], vals[2]};
 
 			(*materials)[curMaterial].specularColor = col;
 		}
-		else if(strcmp(curToken, "d") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_D)
 		{
 			float opacity;
-			fscanf_s(fptr, "%f\n", &opacity);
+			qobj_read_floats(&cur, lineEnd, &opacity, 1);
 
 			(*materials)[curMaterial].opacity = opacity;
 		}
-		else if(strcmp(curToken, "Ns") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_NS)
 		{
 			float specularExp;
-			fscanf_s(fptr, "%f\n", &specularExp);
+			qobj_read_floats(&cur, lineEnd, &specularExp, 1);
 
 			(*materials)[curMaterial].specularExp = specularExp;
 		}
-		else if(strcmp(curToken, "Ni") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_NI)
 		{
 			float refractionIndex;
-			fscanf_s(fptr, "%f\n", &refractionIndex);
+			qobj_read_floats(&cur, lineEnd, &refractionIndex, 1);
 
 			(*materials)[curMaterial].refractionIndex = refractionIndex;
 		}
-		else if(strcmp(curToken, "map_Ka") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_MAP_KA)
 		{
-			char* mapPath = (char*)QOBJ_MALLOC(QOBJ_MAX_TOKEN_LEN * sizeof(char));
-			qobj_fgets(fptr, mapPath, &curTokenEnd);
+			char* mapPath = (char*)qobj_alloc(allocator, QOBJ_MAX_TOKEN_LEN * sizeof(char));
+			qobj_rest_of_line(&cur, lineEnd, mapPath);
 
 			(*materials)[curMaterial].ambientMapPath = mapPath;
 		}
-		else if(strcmp(curToken, "map_Kd") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_MAP_KD)
 		{
-			char* mapPath = (char*)QOBJ_MALLOC(QOBJ_MAX_TOKEN_LEN * sizeof(char));
-			qobj_fgets(fptr, mapPath, &curTokenEnd);
+			char* mapPath = (char*)qobj_alloc(allocator, QOBJ_MAX_TOKEN_LEN * sizeof(char));
+			qobj_rest_of_line(&cur, lineEnd, mapPath);
 
 			(*materials)[curMaterial].diffuseMapPath = mapPath;
 		}
-		else if(strcmp(curToken, "map_Ks") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_MAP_KS)
 		{
-			char* mapPath = (char*)QOBJ_MALLOC(QOBJ_MAX_TOKEN_LEN * sizeof(char));
-			qobj_fgets(fptr, mapPath, &curTokenEnd);
+			char* mapPath = (char*)qobj_alloc(allocator, QOBJ_MAX_TOKEN_LEN * sizeof(char));
+			qobj_rest_of_line(&cur, lineEnd, mapPath);
 
 			(*materials)[curMaterial].specularMapPath = mapPath;
 		}
-		else if(strcmp(curToken, "map_Bump") == 0)
+		else if(keyword == QOBJ_MTL_KEYWORD_MAP_BUMP)
 		{
-			char* mapPath = (char*)QOBJ_MALLOC(QOBJ_MAX_TOKEN_LEN * sizeof(char));
-			qobj_fgets(fptr, mapPath, &curTokenEnd);
+			char* mapPath = (char*)qobj_alloc(allocator, QOBJ_MAX_TOKEN_LEN * sizeof(char));
+			qobj_rest_of_line(&cur, lineEnd, mapPath);
 
 			(*materials)[curMaterial].normalMapPath = mapPath;
 		}
 	}
 
+	if(errorCode == QOBJ_SUCCESS)
+		errorCode = stream->error;
+
 	//cleanup
 	//---------------
 	if(errorCode != QOBJ_SUCCESS)
 	{
-		qobj_free_mtl(*numMaterials, *materials);
+		for(uint32_t i = 0; i < *numMaterials; i++)
+			qobj_material_free((*materials)[i], allocator);
+
+		qobj_free(allocator, *materials);
 		*numMaterials = 0;
+		*materials = NULL;
 	}
 
-	fclose(fptr);
 	return errorCode;	
 }
 
+QOBJerror qobj_load_mtl(const char* path, uint32_t* numMaterials, QOBJmaterial** materials)
+{
+	return qobj_load_mtl_opts(path, NULL, numMaterials, materials);
+}
+
+QOBJerror qobj_load_mtl_opts(const char* path, const QOBJloadOptions* options, uint32_t* numMaterials, QOBJmaterial** materials)
+{
+	//ensure file is valid and able to be opened:
+	//---------------
+	uint32_t pathLen = (uint32_t)strlen(path);
+	if(pathLen < 4 || strcmp(&path[pathLen - 4], ".mtl") != 0)
+		return QOBJ_ERROR_INVALID_FILE;
+
+	//map file into memory if possible:
+	//---------------
+#ifdef QOBJ_MMAP
+	QOBJfile file;
+	if(qobj_file_map(path, &file) == QOBJ_SUCCESS)
+	{
+		QOBJerror errorCode = qobj_load_mtl_from_memory(file.data, file.len, options, numMaterials, materials);
+
+		qobj_file_unmap(file);
+		return errorCode;
+	}
+#endif
+
+	//otherwise, stream file in blocks:
+	//---------------
+	FILE* fptr = qobj_file_open(path);
+	if(!fptr)
+		return QOBJ_ERROR_IO;
+
+	QOBJreader reader = qobj_file_reader(fptr);
+	QOBJerror errorCode = qobj_load_mtl_ex(&reader, options, numMaterials, materials);
+
+	fclose(fptr);
+	return errorCode;
+}
+
+QOBJerror qobj_load_mtl_from_memory(const char* data, size_t len, const QOBJloadOptions* options, uint32_t* numMaterials, QOBJmaterial** materials)
+{
+	QOBJstream stream;
+	qobj_stream_from_memory(&stream, data, len);
+
+	return qobj_load_mtl_stream(&stream, qobj_get_allocator(options ? options->allocator : NULL), numMaterials, materials);
+}
+
+QOBJerror qobj_load_mtl_ex(const QOBJreader* reader, const QOBJloadOptions* options, uint32_t* numMaterials, QOBJmaterial** materials)
+{
+	*numMaterials = 0;
+	*materials = NULL;
+
+	const QOBJallocator* allocator = qobj_get_allocator(options ? options->allocator : NULL);
+
+	QOBJstream stream;
+	QOBJerror streamError = qobj_stream_from_reader(&stream, reader, 0, allocator);
+	if(streamError != QOBJ_SUCCESS)
+		return streamError;
+
+	QOBJerror errorCode = qobj_load_mtl_stream(&stream, allocator, numMaterials, materials);
+
+	qobj_stream_free(&stream);
+	return errorCode;
+}
+
 void qobj_free_mtl(uint32_t numMaterials, QOBJmaterial* materials)
+{
+	qobj_free_mtl_opts(numMaterials, materials, NULL);
+}
+
+void qobj_free_mtl_opts(uint32_t numMaterials, QOBJmaterial* materials, const QOBJloadOptions* options)
 {
 	if(materials == NULL)
 		return;
 
+	const QOBJallocator* allocator = qobj_get_allocator(options ? options->allocator : NULL);
+
 	for(uint32_t i = 0; i < numMaterials; i++)
-		qobj_material_free(materials[i]);
+		qobj_material_free(materials[i], allocator);
 
-	QOBJ_FREE(materials);
+	qobj_free(allocator, materials);
 }
 
 //----------------------------------------------------------------------//
@@ -0,0 +1,338 @@
+//tests that the optional load modes agree with a plain serial load, build and run from the repository root with:
+//	cc -std=c99 -fsanitize=address,undefined -pthread tests/test_load_modes.c -o test_load_modes && ./test_load_modes
+//the same file also builds as C++, with c++ -x c++ in place of cc -std=c99
+//returns 0 if every test passed
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define QOBJ_MIN_CHUNK_SIZE 4096 //so the test model is split into many chunks by parallel loads
+#define QOBJ_IMPLEMENTATION
+#include "../quickobj.h"
+
+//----------------------------------------------------------------------//
+//HELPERS:
+
+static int g_failures = 0;
+
+#define CHECK(cond, name) do { if(!(cond)) { printf("FAIL: %s (%s)\n", name, #cond); g_failures++; } } while(0)
+
+#define MODEL_PATH "test_load_modes.obj"
+
+//the face formats of the model's materials, each material only ever uses one
+static const char* g_materials[] = {"positions", "tex_coords", "normals", "everything"};
+
+#define NUM_MATERIALS (sizeof(g_materials) / sizeof(g_materials[0]))
+
+static uint32_t g_random = 12345;
+
+static uint32_t next_random(uint32_t range)
+{
+	g_random = g_random * 1664525u + 1013904223u;
+	return (g_random >> 8) % range;
+}
+
+//writes a corner of a face in [material]'s format, referring to attribute [index] of [count], as a negative index every so often
+static int write_corner(char* dst, uint32_t material, uint32_t index, uint32_t count)
+{
+	long ref = next_random(4) == 0 ? (long)index - (long)count - 1 : (long)index;
+
+	switch(material)
+	{
+	case 0:
+		return sprintf(dst, " %ld", ref);
+	case 1:
+		return sprintf(dst, " %ld/%ld", ref, ref);
+	case 2:
+		return sprintf(dst, " %ld//%ld", ref, ref);
+	default:
+		return sprintf(dst, " %ld/%ld/%ld", ref, ref, ref);
+	}
+}
+
+//writes a model whose vertex data is interleaved with faces of several materials, switching back and forth between them
+//faces have 3 to 5 corners, and some positions are written again under a new index so they can be welded
+static void write_model(const char* path)
+{
+	const uint32_t numBlocks = 200;
+	size_t cap = (size_t)numBlocks * 4096;
+	char* contents = (char*)malloc(cap);
+	size_t len = 0;
+
+	uint32_t count = 0;
+	for(uint32_t block = 0; block < numBlocks; block++)
+	{
+		//vertex data, each position paired with a tex coord and normal of the same index:
+		//---------------
+		for(uint32_t i = 0; i < 8; i++)
+		{
+			uint32_t id = count++;
+			if(id >= 16 && next_random(8) == 0) //repeat an earlier position under a new index
+				id = next_random(id);
+
+			len += sprintf(&contents[len], "v %u.25 %u.5 %u\nvt 0.%u 0.%u\nvn 0 %u 1\n", id % 17, id % 13, id % 11, id % 10, id % 7, id % 3);
+		}
+
+		//faces of a random material:
+		//---------------
+		uint32_t material = next_random(NUM_MATERIALS);
+		len += sprintf(&contents[len], "usemtl %s\n", g_materials[material]);
+
+		for(uint32_t face = 0; face < 6; face++)
+		{
+			len += sprintf(&contents[len], "f");
+
+			uint32_t numCorners = 3 + next_random(3);
+			for(uint32_t i = 0; i < numCorners; i++)
+				len += write_corner(&contents[len], material, 1 + next_random(count), count);
+
+			len += sprintf(&contents[len], "\n");
+		}
+	}
+
+	FILE* fptr = fopen(path, "wb");
+	if(!fptr)
+	{
+		printf("FAIL: could not write %s\n", path);
+		exit(1);
+	}
+
+	fwrite(contents, 1, len, fptr);
+	fclose(fptr);
+	free(contents);
+}
+
+static QOBJerror load_model(uint32_t flags, uint32_t numThreads, uint32_t* numMeshes, QOBJmesh** meshes)
+{
+	QOBJloadOptions options = qobj_default_load_options();
+	options.flags = flags;
+	options.numThreads = numThreads;
+
+	return qobj_load_obj_opts(MODEL_PATH, &options, numMeshes, meshes);
+}
+
+//returns 1 if both loads are byte for byte the same
+static int meshes_equal(uint32_t numA, const QOBJmesh* a, uint32_t numB, const QOBJmesh* b)
+{
+	if(numA != numB)
+		return 0;
+
+	for(uint32_t i = 0; i < numA; i++)
+	{
+		if(strcmp(a[i].material, b[i].material) != 0 || a[i].vertexAttribs != b[i].vertexAttribs || a[i].vertexStride != b[i].vertexStride ||
+		   a[i].numVertices != b[i].numVertices || a[i].numIndices != b[i].numIndices)
+			return 0;
+
+		if(memcmp(a[i].vertices, b[i].vertices, a[i].numVertices * a[i].vertexStride * sizeof(float)) != 0)
+			return 0;
+		if(a[i].numIndices > 0 && memcmp(a[i].indices, b[i].indices, a[i].numIndices * sizeof(uint32_t)) != 0)
+			return 0;
+	}
+
+	return 1;
+}
+
+//returns 1 if the attributes [vertA] has are the same in [vertB]
+static int vertex_equal(const QOBJmesh* meshA, uint32_t vertA, const QOBJmesh* meshB, uint32_t vertB)
+{
+	const float* a = &meshA->vertices[vertA * meshA->vertexStride];
+	const float* b = &meshB->vertices[vertB * meshB->vertexStride];
+
+	if((meshA->vertexAttribs & meshB->vertexAttribs) != meshA->vertexAttribs)
+		return 0;
+
+	if(meshA->vertexAttribs & QOBJ_VERTEX_ATTRIB_POSITION &&
+	   memcmp(&a[meshA->vertexPosOffset], &b[meshB->vertexPosOffset], QOBJ_ATTRIB_SIZE_POSITION * sizeof(float)) != 0)
+		return 0;
+	if(meshA->vertexAttribs & QOBJ_VERTEX_ATTRIB_NORMAL &&
+	   memcmp(&a[meshA->vertexNormalOffset], &b[meshB->vertexNormalOffset], QOBJ_ATTRIB_SIZE_NORMAL * sizeof(float)) != 0)
+		return 0;
+	if(meshA->vertexAttribs & QOBJ_VERTEX_ATTRIB_TEX_COORDS &&
+	   memcmp(&a[meshA->vertexTexCoordOffset], &b[meshB->vertexTexCoordOffset], QOBJ_ATTRIB_SIZE_TEX_COORDS * sizeof(float)) != 0)
+		return 0;
+
+	return 1;
+}
+
+//returns 1 if both loads draw the same triangles with the same materials, however their vertices are indexed
+//[b] may have more attributes than [a], as long as the ones [a] has match
+static int triangles_equal(uint32_t numA, const QOBJmesh* a, uint32_t numB, const QOBJmesh* b)
+{
+	if(numA != numB)
+		return 0;
+
+	for(uint32_t i = 0; i < numA; i++)
+	{
+		if(strcmp(a[i].material, b[i].material) != 0 || a[i].numIndices != b[i].numIndices)
+			return 0;
+
+		for(uint32_t j = 0; j < a[i].numIndices; j++)
+		{
+			if(b[i].indices[j] >= b[i].numVertices || !vertex_equal(&a[i], a[i].indices[j], &b[i], b[i].indices[j]))
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+//returns the number of vertices of [mesh] whose attributes differ from every vertex before them
+static uint32_t count_unique_vertices(const QOBJmesh* mesh)
+{
+	uint32_t numUnique = 0;
+	for(uint32_t i = 0; i < mesh->numVertices; i++)
+	{
+		uint32_t j = 0;
+		while(j < i && !vertex_equal(mesh, i, mesh, j))
+			j++;
+
+		numUnique += (j == i);
+	}
+
+	return numUnique;
+}
+
+//----------------------------------------------------------------------//
+//TESTS:
+
+//parallel loads are identical to the serial load, with any number of threads
+static void test_parallel(uint32_t numExpected, const QOBJmesh* expected)
+{
+	static const uint32_t threadCounts[] = {1, 2, 3, 8};
+
+	for(uint32_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++)
+	{
+		uint32_t numMeshes;
+		QOBJmesh* meshes;
+
+		CHECK(load_model(QOBJ_LOAD_PARALLEL, threadCounts[i], &numMeshes, &meshes) == QOBJ_SUCCESS, "parallel: load");
+		CHECK(meshes_equal(numExpected, expected, numMeshes, meshes), "parallel: identical to the serial load");
+
+		qobj_free_obj(numMeshes, meshes);
+	}
+}
+
+//sort-based deduplication is identical to the serial load, whether or not it is parsed in parallel and with any number of threads
+static void test_sort_dedup(uint32_t numExpected, const QOBJmesh* expected)
+{
+	static const uint32_t threadCounts[] = {1, 2, 8};
+
+	for(uint32_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++)
+	{
+		for(uint32_t parallel = 0; parallel < 2; parallel++)
+		{
+			uint32_t numMeshes;
+			QOBJmesh* meshes;
+			uint32_t flags = QOBJ_LOAD_SORT_DEDUP | (parallel ? QOBJ_LOAD_PARALLEL : 0);
+
+			CHECK(load_model(flags, threadCounts[i], &numMeshes, &meshes) == QOBJ_SUCCESS, "sort dedup: load");
+			CHECK(meshes_equal(numExpected, expected, numMeshes, meshes), "sort dedup: identical to the serial load");
+
+			qobj_free_obj(numMeshes, meshes);
+		}
+	}
+}
+
+//welding draws the same triangles as the serial load, with every repeated vertex merged, and parallel welds are identical
+static void test_weld(uint32_t numExpected, const QOBJmesh* expected)
+{
+	uint32_t numMeshes, numParallel;
+	QOBJmesh* meshes;
+	QOBJmesh* parallel;
+
+	CHECK(load_model(QOBJ_LOAD_WELD, 0, &numMeshes, &meshes) == QOBJ_SUCCESS, "weld: load");
+	CHECK(triangles_equal(numExpected, expected, numMeshes, meshes), "weld: same triangles as the serial load");
+
+	uint32_t numWelded = 0, numUnwelded = 0;
+	for(uint32_t i = 0; i < numMeshes && i < numExpected; i++)
+	{
+		CHECK(meshes[i].numVertices == count_unique_vertices(&expected[i]), "weld: every repeated vertex is merged");
+
+		numWelded += meshes[i].numVertices;
+		numUnwelded += expected[i].numVertices;
+	}
+
+	CHECK(numWelded < numUnwelded, "weld: the model has vertices to weld");
+
+	CHECK(load_model(QOBJ_LOAD_WELD | QOBJ_LOAD_PARALLEL, 3, &numParallel, &parallel) == QOBJ_SUCCESS, "weld: parallel load");
+	CHECK(meshes_equal(numMeshes, meshes, numParallel, parallel), "weld: parallel identical to serial");
+
+	qobj_free_obj(numMeshes, meshes);
+	qobj_free_obj(numParallel, parallel);
+}
+
+//returns 1 if [meshes] share one vertex buffer, and split one index buffer into back to back ranges in mesh order
+static int shared_ranges_valid(uint32_t numMeshes, const QOBJmesh* meshes)
+{
+	uint32_t firstIndex = 0;
+	for(uint32_t i = 0; i < numMeshes; i++)
+	{
+		if(meshes[i].vertices != meshes[0].vertices || meshes[i].numVertices != meshes[0].numVertices ||
+		   meshes[i].vertexStride != meshes[0].vertexStride || meshes[i].vertexAttribs != meshes[0].vertexAttribs)
+			return 0;
+
+		if(meshes[i].firstIndex != firstIndex || meshes[i].indices != meshes[0].indices + firstIndex)
+			return 0;
+
+		firstIndex += meshes[i].numIndices;
+	}
+
+	return meshes[0].indexCap >= firstIndex;
+}
+
+//shared vertices draw the same triangles as the serial load from one buffer, and agree with every way of loading them
+static void test_shared(uint32_t numExpected, const QOBJmesh* expected)
+{
+	static const uint32_t extraFlags[] = {QOBJ_LOAD_PARALLEL, QOBJ_LOAD_SORT_DEDUP, QOBJ_LOAD_SORT_DEDUP | QOBJ_LOAD_PARALLEL};
+
+	uint32_t numShared;
+	QOBJmesh* shared;
+
+	CHECK(load_model(QOBJ_LOAD_SHARED_VERTICES, 0, &numShared, &shared) == QOBJ_SUCCESS, "shared: load");
+	CHECK(shared_ranges_valid(numShared, shared), "shared: one vertex buffer and contiguous index ranges");
+	CHECK(triangles_equal(numExpected, expected, numShared, shared), "shared: same triangles as the serial load");
+
+	for(uint32_t i = 0; i < sizeof(extraFlags) / sizeof(extraFlags[0]); i++)
+	{
+		uint32_t numMeshes;
+		QOBJmesh* meshes;
+
+		CHECK(load_model(QOBJ_LOAD_SHARED_VERTICES | extraFlags[i], 3, &numMeshes, &meshes) == QOBJ_SUCCESS, "shared: load with other flags");
+		CHECK(shared_ranges_valid(numMeshes, meshes), "shared: ranges with other flags");
+		CHECK(meshes_equal(numShared, shared, numMeshes, meshes), "shared: identical with other flags");
+
+		qobj_free_obj(numMeshes, meshes);
+	}
+
+	qobj_free_obj(numShared, shared);
+}
+
+int main(void)
+{
+	write_model(MODEL_PATH);
+
+	uint32_t numExpected;
+	QOBJmesh* expected;
+	if(load_model(0, 0, &numExpected, &expected) != QOBJ_SUCCESS)
+	{
+		printf("FAIL: serial load\n");
+		remove(MODEL_PATH);
+		return 1;
+	}
+
+	CHECK(numExpected == NUM_MATERIALS, "serial: every material has a mesh");
+
+	test_parallel(numExpected, expected);
+	test_sort_dedup(numExpected, expected);
+	test_weld(numExpected, expected);
+	test_shared(numExpected, expected);
+
+	qobj_free_obj(numExpected, expected);
+	remove(MODEL_PATH);
+
+	if(g_failures == 0)
+		printf("all tests passed\n");
+
+	return g_failures == 0 ? 0 : 1;
+}
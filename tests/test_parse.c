@@ -0,0 +1,193 @@
+//tests for parsing .obj lines, build and run from the repository root with:
+//	cc -std=c99 -fsanitize=address,undefined -pthread tests/test_parse.c -o test_parse && ./test_parse
+//the same file also builds as C++, with c++ -x c++ in place of cc -std=c99
+//returns 0 if every test passed
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+
+#define QOBJ_MIN_CHUNK_SIZE 1 //so even tiny files are split into chunks by parallel loads
+#define QOBJ_IMPLEMENTATION
+#include "../quickobj.h"
+
+//----------------------------------------------------------------------//
+//HELPERS:
+
+static int g_failures = 0;
+
+#define CHECK(cond, name) do { if(!(cond)) { printf("FAIL: %s (%s)\n", name, #cond); g_failures++; } } while(0)
+
+//the flags every test loads with, so the serial and the parallel parsers are both covered
+static const uint32_t g_loadFlags[] = {
+	0,
+	QOBJ_LOAD_PARALLEL,
+	QOBJ_LOAD_SORT_DEDUP,
+	QOBJ_LOAD_SHARED_VERTICES,
+	QOBJ_LOAD_PREFLIGHT
+};
+
+#define NUM_LOAD_FLAGS (sizeof(g_loadFlags) / sizeof(g_loadFlags[0]))
+
+//loads [data] with [flags], [numIndices] is set to the total number of indices loaded
+static QOBJerror load_text(const char* data, uint32_t flags, uint32_t* numIndices)
+{
+	QOBJloadOptions options = qobj_default_load_options();
+	options.flags = flags;
+	options.numThreads = 2;
+
+	uint32_t numMeshes;
+	QOBJmesh* meshes;
+	QOBJerror errorCode = qobj_load_obj_from_memory(data, strlen(data), &options, &numMeshes, &meshes);
+
+	*numIndices = 0;
+	for(uint32_t i = 0; i < numMeshes; i++)
+		*numIndices += meshes[i].numIndices;
+
+	qobj_free_obj(numMeshes, meshes);
+	return errorCode;
+}
+
+//----------------------------------------------------------------------//
+//TESTS:
+
+#define QUAD_POSITIONS "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\n"
+
+//faces with a bad corner anywhere on the line fail, faces that simply end (or end in a comment) load
+static void test_face_corners(void)
+{
+	static const struct
+	{
+		const char* face;
+		QOBJerror expected;
+		uint32_t numIndices;
+	} cases[] = {
+		{"f 1 2 3\n",           QOBJ_SUCCESS,            3},
+		{"f 1 2 3 4\n",         QOBJ_SUCCESS,            6},
+		{"f 1 2 3 4 \r\n",      QOBJ_SUCCESS,            6},
+		{"f 1 2 3 -4\n",        QOBJ_SUCCESS,            6},
+		{"f 1 2 3 # comment\n", QOBJ_SUCCESS,            3},
+		{"f 1 2 3 4#comment\n", QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 1 2 3 99\n",        QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 1 2 3 0\n",         QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 1 2 3 -5\n",        QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 1 2 3 x4\n",        QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 1 2 3 4/1\n",       QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 1 2 3 4//\n",       QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 1 2 3 4 5\n",       QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 1 2 99 4\n",        QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 99 1 2\n",          QOBJ_ERROR_INVALID_FILE, 0},
+		{"f 1 2\n",             QOBJ_ERROR_INVALID_FILE, 0},
+		{"f\n",                 QOBJ_ERROR_INVALID_FILE, 0}
+	};
+
+	for(uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+	{
+		//the bad face is followed by a good one, so a parser that skips it would still load something
+		char data[256];
+		snprintf(data, sizeof(data), QUAD_POSITIONS "usemtl a\n%sf 1 2 3\n", cases[i].face);
+
+		for(uint32_t j = 0; j < NUM_LOAD_FLAGS; j++)
+		{
+			uint32_t numIndices;
+			QOBJerror errorCode = load_text(data, g_loadFlags[j], &numIndices);
+			uint32_t expectedIndices = cases[i].expected == QOBJ_SUCCESS ? cases[i].numIndices + 3 : 0;
+
+			if(errorCode != cases[i].expected || numIndices != expectedIndices)
+			{
+				printf("FAIL: face corners \"%.*s\" with flags %u returned %d and %u indices, expected %d and %u\n", (int)strlen(cases[i].face) - 1,
+				       cases[i].face, g_loadFlags[j], (int)errorCode, numIndices, (int)cases[i].expected, expectedIndices);
+				g_failures++;
+			}
+		}
+	}
+}
+
+//forms of floats the fast path can not round exactly, all are parsed as strtof() does in the "C" locale
+static const char* g_slowFloats[] = {
+	"1.5e-30", "-2.5e+38", "1e-40", "1.4e-45", "7.006492321624085e-46", "7.006492321624086e-46", "1e-46", "3.4028235e38",
+	"3.40282357e38", "1e39", "1e-400", "1e400", "16777217", "16777217.000000000000000000001", "33554433e-1",
+	"1.000000059604644775390625", "1.0000000596046447753906250000000000000000000000000000001", "12345678901234567890123",
+	"0.000000000000000000000000000000000000011754943508222875", "340282356779733661637539395458142568448",
+	"inf", "-Infinity", "INF"
+};
+
+#define NUM_SLOW_FLOATS (sizeof(g_slowFloats) / sizeof(g_slowFloats[0]))
+
+//a locale whose decimal separator is a comma, if the system has one
+static const char* set_comma_locale(void)
+{
+	static const char* names[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR", "German", "French"};
+
+	for(uint32_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+	{
+		if(setlocale(LC_NUMERIC, names[i]) && strcmp(localeconv()->decimal_point, ",") == 0)
+			return names[i];
+	}
+
+	setlocale(LC_NUMERIC, "C");
+	return NULL;
+}
+
+//floats on the slow path parse the same, and as every component of a vertex, whatever the locale's decimal separator is
+static void test_slow_floats(void)
+{
+	float expected[NUM_SLOW_FLOATS];
+	for(uint32_t i = 0; i < NUM_SLOW_FLOATS; i++)
+		expected[i] = strtof(g_slowFloats[i], NULL);
+
+	const char* locale = set_comma_locale();
+	if(!locale)
+		printf("note: no locale with a comma decimal separator, slow floats are only tested in the \"C\" locale\n");
+
+	for(uint32_t i = 0; i < NUM_SLOW_FLOATS; i++)
+	{
+		//a vertex with the float as every component, then a position using it as its last component
+		char data[512];
+		snprintf(data, sizeof(data), "v %s %s %s\nv 1 2 %s\nf 1 1 2\n", g_slowFloats[i], g_slowFloats[i], g_slowFloats[i], g_slowFloats[i]);
+
+		uint32_t numMeshes;
+		QOBJmesh* meshes;
+		QOBJloadOptions options = qobj_default_load_options();
+		options.flags = QOBJ_LOAD_NO_DEDUP;
+
+		if(qobj_load_obj_from_memory(data, strlen(data), &options, &numMeshes, &meshes) != QOBJ_SUCCESS)
+		{
+			printf("FAIL: slow float \"%s\" did not load\n", g_slowFloats[i]);
+			g_failures++;
+			continue;
+		}
+
+		const QOBJmesh* mesh = &meshes[0];
+		const float* first = &mesh->vertices[mesh->vertexPosOffset];
+		const float* last = &mesh->vertices[2 * mesh->vertexStride + mesh->vertexPosOffset];
+
+		float values[4] = {first[0], first[1], first[2], last[2]};
+		for(uint32_t j = 0; j < 4; j++)
+		{
+			if(memcmp(&values[j], &expected[i], sizeof(float)) != 0)
+			{
+				printf("FAIL: slow float \"%s\" parsed as %.9g, expected %.9g\n", g_slowFloats[i], values[j], expected[i]);
+				g_failures++;
+				break;
+			}
+		}
+
+		CHECK(last[0] == 1.0f && last[1] == 2.0f, "slow floats: components before the slow one");
+		qobj_free_obj(numMeshes, meshes);
+	}
+
+	setlocale(LC_NUMERIC, "C");
+}
+
+int main(void)
+{
+	test_face_corners();
+	test_slow_floats();
+
+	if(g_failures == 0)
+		printf("all tests passed\n");
+
+	return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+//tests for qobj_reload_obj(), build and run from the repository root with:
+//	cc -std=c99 -fsanitize=address,undefined -pthread tests/test_reload.c -o test_reload && ./test_reload
+//the same file also builds as C++, with c++ -x c++ in place of cc -std=c99
+//returns 0 if every test passed
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define QOBJ_IMPLEMENTATION
+#include "../quickobj.h"
+
+//----------------------------------------------------------------------//
+//TRACKING ALLOCATOR:
+
+//stores each block's size in front of it, so the old size passed to realloc can be checked
+typedef struct TrackedAllocator
+{
+	long live;
+	long badOldSizes;
+} TrackedAllocator;
+
+static void* tracked_alloc(void* user, size_t size)
+{
+	size_t* block = (size_t*)malloc(size + 2 * sizeof(size_t));
+	if(!block)
+		return NULL;
+
+	block[0] = size;
+	((TrackedAllocator*)user)->live++;
+	return block + 2;
+}
+
+static void* tracked_realloc(void* user, void* ptr, size_t oldSize, size_t newSize)
+{
+	if(!ptr)
+		return tracked_alloc(user, newSize);
+
+	size_t* block = (size_t*)ptr - 2;
+	if(block[0] != oldSize)
+		((TrackedAllocator*)user)->badOldSizes++;
+
+	block = (size_t*)realloc(block, newSize + 2 * sizeof(size_t));
+	if(!block)
+		return NULL;
+
+	block[0] = newSize;
+	return block + 2;
+}
+
+static void tracked_free(void* user, void* ptr)
+{
+	((TrackedAllocator*)user)->live--;
+	free((size_t*)ptr - 2);
+}
+
+//----------------------------------------------------------------------//
+//HELPERS:
+
+static int g_failures = 0;
+
+#define CHECK(cond, name) do { if(!(cond)) { printf("FAIL: %s (%s)\n", name, #cond); g_failures++; } } while(0)
+
+static void write_file(const char* path, const char* contents)
+{
+	FILE* fptr = fopen(path, "wb");
+	if(!fptr)
+	{
+		printf("FAIL: could not write %s\n", path);
+		exit(1);
+	}
+
+	fputs(contents, fptr);
+	fclose(fptr);
+}
+
+//writes a model with 3 * [numFaces] positions, tex coords and normals, whose faces use tex coords and normals only if [full]
+//the first face only ever has positions, so a model with shared vertices widens its layout after it
+static void write_model(const char* path, uint32_t numFaces, int full)
+{
+	size_t cap = 256 + (size_t)numFaces * 160;
+	char* contents = (char*)malloc(cap);
+	size_t len = 0;
+
+	for(uint32_t i = 0; i < numFaces * 3; i++)
+		len += sprintf(&contents[len], "v %u %u 0\nvt 0.5 0.5\nvn 0 0 1\n", i, i % 7);
+
+	len += sprintf(&contents[len], "usemtl first\nf 1 2 3\nusemtl second\n");
+	for(uint32_t i = 1; i < numFaces; i++)
+	{
+		uint32_t a = i * 3 + 1, b = i * 3 + 2, c = i * 3 + 3;
+		if(full)
+			len += sprintf(&contents[len], "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+		else
+			len += sprintf(&contents[len], "f %u %u %u\n", a, b, c);
+	}
+
+	write_file(path, contents);
+	free(contents);
+}
+
+static int meshes_equal(uint32_t numA, const QOBJmesh* a, uint32_t numB, const QOBJmesh* b)
+{
+	if(numA != numB)
+		return 0;
+
+	for(uint32_t i = 0; i < numA; i++)
+	{
+		if(strcmp(a[i].material, b[i].material) != 0 || a[i].vertexStride != b[i].vertexStride ||
+		   a[i].numVertices != b[i].numVertices || a[i].numIndices != b[i].numIndices || a[i].firstIndex != b[i].firstIndex)
+			return 0;
+
+		if(memcmp(a[i].vertices, b[i].vertices, a[i].numVertices * a[i].vertexStride * sizeof(float)) != 0)
+			return 0;
+		if(a[i].numIndices > 0 && memcmp(a[i].indices, b[i].indices, a[i].numIndices * sizeof(uint32_t)) != 0)
+			return 0;
+	}
+
+	return 1;
+}
+
+//----------------------------------------------------------------------//
+//TESTS:
+
+#define NARROW_PATH "test_reload_narrow.obj"
+#define WIDE_PATH   "test_reload_wide.obj"
+
+//reloads a file whose layout widens after its first face over meshes loaded with a narrower layout
+static void test_widening_layout(uint32_t flags)
+{
+	TrackedAllocator tracked = {0, 0};
+	QOBJallocator allocator = {tracked_alloc, tracked_realloc, tracked_free, &tracked};
+
+	QOBJloadOptions options = qobj_default_load_options();
+	options.flags = flags;
+	options.allocator = &allocator;
+
+	uint32_t numMeshes, numExpected;
+	QOBJmesh* meshes;
+	QOBJmesh* expected;
+
+	CHECK(qobj_load_obj_opts(NARROW_PATH, &options, &numMeshes, &meshes) == QOBJ_SUCCESS, "widening: load narrow");
+	CHECK(qobj_reload_obj(WIDE_PATH, &options, &numMeshes, &meshes) == QOBJ_SUCCESS, "widening: reload wide");
+	CHECK(qobj_load_obj_opts(WIDE_PATH, &options, &numExpected, &expected) == QOBJ_SUCCESS, "widening: load wide");
+	CHECK(meshes_equal(numMeshes, meshes, numExpected, expected), "widening: reload matches load");
+
+	CHECK(qobj_reload_obj(NARROW_PATH, &options, &numMeshes, &meshes) == QOBJ_SUCCESS, "widening: reload narrow");
+
+	qobj_free_obj_opts(numMeshes, meshes, &options);
+	qobj_free_obj_opts(numExpected, expected, &options);
+
+	CHECK(tracked.badOldSizes == 0, "widening: realloc old sizes");
+	CHECK(tracked.live == 0, "widening: no leaks");
+}
+
+//reloads meshes packed into a single block without the flag, and the other way around, then frees them without options
+static void test_single_block_mismatch(int packedFirst)
+{
+	TrackedAllocator tracked = {0, 0};
+	QOBJallocator allocator = {tracked_alloc, tracked_realloc, tracked_free, &tracked};
+
+	QOBJloadOptions packed = qobj_default_load_options();
+	packed.flags = QOBJ_LOAD_SINGLE_BLOCK;
+	packed.allocator = &allocator;
+
+	QOBJloadOptions unpacked = qobj_default_load_options();
+	unpacked.allocator = &allocator;
+
+	const QOBJloadOptions* first = packedFirst ? &packed : &unpacked;
+	const QOBJloadOptions* second = packedFirst ? &unpacked : &packed;
+
+	uint32_t numMeshes, numExpected;
+	QOBJmesh* meshes;
+	QOBJmesh* expected;
+
+	CHECK(qobj_load_obj_opts(WIDE_PATH, first, &numMeshes, &meshes) == QOBJ_SUCCESS, "single block: load");
+	CHECK((meshes[0].block != NULL) == packedFirst, "single block: block is set only when packed");
+	CHECK(qobj_reload_obj(WIDE_PATH, second, &numMeshes, &meshes) == QOBJ_SUCCESS, "single block: reload");
+	CHECK(qobj_reload_obj(NARROW_PATH, second, &numMeshes, &meshes) == QOBJ_SUCCESS, "single block: reload again");
+	CHECK(qobj_reload_obj(NARROW_PATH, first, &numMeshes, &meshes) == QOBJ_SUCCESS, "single block: reload back");
+
+	CHECK(qobj_load_obj_opts(NARROW_PATH, second, &numExpected, &expected) == QOBJ_SUCCESS, "single block: load expected");
+	CHECK(meshes_equal(numMeshes, meshes, numExpected, expected), "single block: reload matches load");
+
+	qobj_free_obj_opts(numMeshes, meshes, &unpacked);
+	qobj_free_obj_opts(numExpected, expected, &unpacked);
+
+	CHECK(tracked.badOldSizes == 0, "single block: realloc old sizes");
+	CHECK(tracked.live == 0, "single block: no leaks");
+}
+
+//packs shared meshes into a single block, whose first mesh's caps must cover the whole shared buffers
+static void test_single_block_shared(void)
+{
+	TrackedAllocator tracked = {0, 0};
+	QOBJallocator allocator = {tracked_alloc, tracked_realloc, tracked_free, &tracked};
+
+	QOBJloadOptions options = qobj_default_load_options();
+	options.flags = QOBJ_LOAD_SINGLE_BLOCK | QOBJ_LOAD_SHARED_VERTICES;
+	options.allocator = &allocator;
+
+	uint32_t numMeshes;
+	QOBJmesh* meshes;
+
+	CHECK(qobj_load_obj_opts(WIDE_PATH, &options, &numMeshes, &meshes) == QOBJ_SUCCESS, "single block shared: load");
+	CHECK(numMeshes == 2, "single block shared: mesh count");
+
+	uint32_t numIndices = 0;
+	for(uint32_t i = 0; i < numMeshes; i++)
+		numIndices += meshes[i].numIndices;
+
+	CHECK(meshes[0].indexCap == numIndices, "single block shared: index cap covers every mesh's indices");
+	CHECK(meshes[0].vertexCap == meshes[0].numVertices, "single block shared: vertex cap");
+	CHECK(meshes[1].indices == meshes[0].indices + meshes[1].firstIndex, "single block shared: ranges point into the block");
+
+	CHECK(qobj_reload_obj(NARROW_PATH, &options, &numMeshes, &meshes) == QOBJ_SUCCESS, "single block shared: reload");
+	qobj_free_obj_opts(numMeshes, meshes, &options);
+
+	CHECK(tracked.badOldSizes == 0, "single block shared: realloc old sizes");
+	CHECK(tracked.live == 0, "single block shared: no leaks");
+}
+
+int main(void)
+{
+	write_model(NARROW_PATH, 400, 0);
+	write_model(WIDE_PATH, 400, 1);
+
+	test_widening_layout(0);
+	test_widening_layout(QOBJ_LOAD_SHARED_VERTICES);
+	test_widening_layout(QOBJ_LOAD_SHARED_VERTICES | QOBJ_LOAD_SORT_DEDUP);
+	test_widening_layout(QOBJ_LOAD_SHARED_VERTICES | QOBJ_LOAD_NO_DEDUP);
+	test_single_block_mismatch(1);
+	test_single_block_mismatch(0);
+	test_single_block_shared();
+
+	remove(NARROW_PATH);
+	remove(WIDE_PATH);
+
+	if(g_failures == 0)
+		printf("all tests passed\n");
+
+	return g_failures == 0 ? 0 : 1;
+}